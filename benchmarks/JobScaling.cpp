@@ -0,0 +1,137 @@
+// JobSystem::parallelFor scaling from 1 to N threads on a particle simulation: make benchmark
+//
+// Usage: job-scaling [particles] [iterations] [threads]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <Engine/Jobs/JobSystem.hpp>
+
+namespace
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    struct Particles
+    {
+        std::vector<float> x, y, z;
+        std::vector<float> vx, vy, vz;
+
+        explicit Particles(size_t count)
+            : x(count), y(count), z(count), vx(count), vy(count), vz(count)
+        {
+            std::mt19937 random(42);
+            std::uniform_real_distribution<float> position(-100.f, 100.f);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                x[i] = position(random);
+                y[i] = position(random);
+                z[i] = position(random);
+                vx[i] = vy[i] = vz[i] = 0.f;
+            }
+        }
+    };
+
+    // a few attractors, bounced inside a box: compute bound, every particle is independent
+    void simulate(Particles& particles, size_t begin, size_t end)
+    {
+        static const float attractors[4][3] = { { 50.f, 0.f, 0.f }, { -50.f, 0.f, 0.f }, { 0.f, 50.f, 0.f }, { 0.f, 0.f, -50.f } };
+        const float step = 1.f / 60.f;
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            float ax = 0.f, ay = 0.f, az = 0.f;
+
+            for (const auto& attractor : attractors)
+            {
+                const float dx = attractor[0] - particles.x[i];
+                const float dy = attractor[1] - particles.y[i];
+                const float dz = attractor[2] - particles.z[i];
+                const float distanceSquared = dx * dx + dy * dy + dz * dz + 1.f;
+                const float inverse = 1.f / (distanceSquared * std::sqrt(distanceSquared));
+
+                ax += dx * inverse;
+                ay += dy * inverse;
+                az += dz * inverse;
+            }
+
+            particles.vx[i] = (particles.vx[i] + ax * 500.f * step) * 0.999f;
+            particles.vy[i] = (particles.vy[i] + ay * 500.f * step) * 0.999f;
+            particles.vz[i] = (particles.vz[i] + az * 500.f * step) * 0.999f;
+
+            particles.x[i] = std::max(-100.f, std::min(100.f, particles.x[i] + particles.vx[i] * step));
+            particles.y[i] = std::max(-100.f, std::min(100.f, particles.y[i] + particles.vy[i] * step));
+            particles.z[i] = std::max(-100.f, std::min(100.f, particles.z[i] + particles.vz[i] * step));
+        }
+    }
+
+    double checksum(const Particles& particles)
+    {
+        double sum = 0.0;
+
+        for (size_t i = 0; i < particles.x.size(); ++i)
+        {
+            sum += particles.x[i] + particles.y[i] + particles.z[i];
+        }
+
+        return sum;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50;
+    const size_t maxThreads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::printf("%zu particles, %zu iterations, 1..%zu threads\n\n", count, iterations, maxThreads);
+
+    double baseline = 0.0;
+    double reference = 0.0;
+    int result = 0;
+
+    for (size_t threads = 1; threads <= maxThreads; ++threads)
+    {
+        // the main thread takes part in parallelFor: one worker less
+        isc::jobs::JobSystem jobs(threads - 1);
+        Particles particles(count);
+
+        // warm up: worker start, first touch of the memory
+        jobs.parallelFor(0, count, [&](size_t begin, size_t end) { simulate(particles, begin, end); });
+
+        const auto start = Clock::now();
+
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            jobs.parallelFor(0, count, [&](size_t begin, size_t end) { simulate(particles, begin, end); });
+        }
+
+        const double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / static_cast<double>(iterations);
+
+        if (threads == 1)
+        {
+            baseline = milliseconds;
+            reference = checksum(particles);
+        }
+        else if (checksum(particles) != reference)
+        {
+            // every particle only depends on itself: the split can't change the result
+            result = 1;
+        }
+
+        const double speedup = baseline / milliseconds;
+
+        std::printf("%2zu threads %9.2f ms/update   x%5.2f   efficiency %5.1f%%   grain %zu\n",
+            threads, milliseconds, speedup, 100.0 * speedup / static_cast<double>(threads), jobs.getGrainSize(count));
+    }
+
+    std::printf("\nresults %s\n", result == 0 ? "match" : "differ");
+
+    return result;
+}
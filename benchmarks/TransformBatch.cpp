@@ -0,0 +1,94 @@
+// TransformBatch kernels against plain glm: make benchmark
+//
+// Usage: transform-batch [objects] [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <Engine/Graphics/Camera.hpp>
+#include <Engine/Graphics/TransformBatch.hpp>
+
+namespace
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    template<typename TFunction>
+    double measure(size_t iterations, TFunction function)
+    {
+        // warm up: first touch of the memory, branch predictors
+        function();
+
+        const auto start = Clock::now();
+
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            function();
+        }
+
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / static_cast<double>(iterations);
+    }
+
+    void report(const char* name, double scalar, double simd, size_t objects)
+    {
+        std::printf("%-8s scalar %9.1f us (%5.2f ns/object)   simd %9.1f us (%5.2f ns/object)   x%.2f\n",
+            name,
+            scalar, scalar * 1000.0 / static_cast<double>(objects),
+            simd, simd * 1000.0 / static_cast<double>(objects),
+            scalar / simd);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t objects = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-100.f, 100.f);
+    std::uniform_real_distribution<float> angle(0.f, 6.28318f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.f);
+
+    isc::TransformBatch batch;
+
+    for (size_t i = 0; i < objects; ++i)
+    {
+        glm::mat4 local = glm::translate(glm::mat4(1.f), glm::vec3(position(random), position(random), position(random)));
+        local = glm::rotate(local, angle(random), glm::normalize(glm::vec3(position(random), position(random), position(random)) + 0.001f));
+        local = glm::scale(local, glm::vec3(scale(random)));
+
+        batch.add(local, glm::vec3(0.f), 1.f);
+    }
+
+    isc::Camera camera;
+    camera.setViewportSize({ 1280, 720 });
+    camera.lookAt(glm::vec3(0.f, 0.f, -150.f), glm::vec3(0.f));
+    camera.update();
+
+    const glm::mat4 parent = glm::rotate(glm::mat4(1.f), 0.3f, glm::vec3(0.f, 1.f, 0.f));
+    std::vector<isc::TransformBatch::Index> visible;
+    std::vector<isc::TransformBatch::Index> reference;
+
+    std::printf("%zu objects, %zu iterations, %s\n\n", objects, iterations, isc::TransformBatch::getInstructionSet());
+
+    const double worldScalar = measure(iterations, [&]() { batch.updateScalar(parent); });
+    const double worldSimd = measure(iterations, [&]() { batch.update(parent); });
+    report("world", worldScalar, worldSimd, objects);
+
+    const double clipScalar = measure(iterations, [&]() { batch.updateClipScalar(camera.getViewProjection()); });
+    const double clipSimd = measure(iterations, [&]() { batch.updateClip(camera.getViewProjection()); });
+    report("clip", clipScalar, clipSimd, objects);
+
+    const double cullScalar = measure(iterations, [&]() { batch.cullScalar(camera.getFrustum(), reference); });
+    const double cullSimd = measure(iterations, [&]() { batch.cull(camera.getFrustum(), visible); });
+    report("cull", cullScalar, cullSimd, objects);
+
+    // different operation order (fused multiply-add) can only flip spheres exactly on a plane
+    std::printf("\nvisible: %zu (scalar %zu)\n", visible.size(), reference.size());
+
+    return visible.size() == reference.size() ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#include "FrameHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace isc
+{
+    constexpr uint32_t FrameHistogram::SubBucketBits;
+    constexpr uint32_t FrameHistogram::SubBucketCount;
+    constexpr uint32_t FrameHistogram::MaxValueBits;
+    constexpr uint32_t FrameHistogram::BucketCount;
+
+    namespace
+    {
+        uint32_t getHighestBit(uint64_t value) noexcept
+        {
+            uint32_t bit = 0;
+
+            while (value >>= 1)
+            {
+                ++bit;
+            }
+
+            return bit;
+        }
+
+        uint64_t toMicroseconds(DeltaTime time) noexcept
+        {
+            const double microseconds = time.count() * 1000.0;
+
+            return microseconds > 0
+                ? static_cast<uint64_t>(microseconds + 0.5)
+                : 0;
+        }
+
+        DeltaTime fromMicroseconds(uint64_t microseconds) noexcept
+        {
+            return DeltaTime(microseconds / 1000.0);
+        }
+    }
+
+    FrameHistogram::FrameHistogram(DeltaTime budget)
+        : _budget(budget)
+    {
+        reset();
+    }
+
+    void FrameHistogram::reset() noexcept
+    {
+        _buckets.fill(0);
+        _count = 0;
+        _overBudgetCount = 0;
+        _totalMicroseconds = 0;
+        _minMicroseconds = std::numeric_limits<uint64_t>::max();
+        _maxMicroseconds = 0;
+    }
+
+    uint32_t FrameHistogram::getBucketIndex(uint64_t microseconds) noexcept
+    {
+        const uint64_t maxValue = (1ull << MaxValueBits) - 1;
+        microseconds = std::min(microseconds, maxValue);
+
+        if (microseconds < SubBucketCount)
+        {
+            return static_cast<uint32_t>(microseconds);
+        }
+
+        // mantissa in [SubBucketCount, 2 * SubBucketCount)
+        const uint32_t exponent = getHighestBit(microseconds) - SubBucketBits;
+        const uint64_t mantissa = microseconds >> exponent;
+
+        return (exponent + 1) * SubBucketCount + static_cast<uint32_t>(mantissa - SubBucketCount);
+    }
+
+    uint64_t FrameHistogram::getBucketUpperBound(uint32_t index) noexcept
+    {
+        if (index < SubBucketCount)
+        {
+            return index;
+        }
+
+        const uint32_t exponent = index / SubBucketCount - 1;
+        const uint64_t mantissa = SubBucketCount + index % SubBucketCount;
+
+        return ((mantissa + 1) << exponent) - 1;
+    }
+
+    void FrameHistogram::record(DeltaTime frameTime) noexcept
+    {
+        const uint64_t microseconds = toMicroseconds(frameTime);
+
+        ++_buckets[getBucketIndex(microseconds)];
+        ++_count;
+        _totalMicroseconds += microseconds;
+        _minMicroseconds = std::min(_minMicroseconds, microseconds);
+        _maxMicroseconds = std::max(_maxMicroseconds, microseconds);
+
+        if (frameTime > _budget)
+        {
+            ++_overBudgetCount;
+        }
+    }
+
+    uint64_t FrameHistogram::getCount() const noexcept
+    {
+        return _count;
+    }
+
+    uint64_t FrameHistogram::getOverBudgetCount() const noexcept
+    {
+        return _overBudgetCount;
+    }
+
+    DeltaTime FrameHistogram::getBudget() const noexcept
+    {
+        return _budget;
+    }
+
+    DeltaTime FrameHistogram::getMin() const noexcept
+    {
+        return fromMicroseconds(_count > 0 ? _minMicroseconds : 0);
+    }
+
+    DeltaTime FrameHistogram::getMax() const noexcept
+    {
+        return fromMicroseconds(_maxMicroseconds);
+    }
+
+    DeltaTime FrameHistogram::getMean() const noexcept
+    {
+        return _count > 0
+            ? fromMicroseconds(_totalMicroseconds) / static_cast<double>(_count)
+            : DeltaTime(0);
+    }
+
+    DeltaTime FrameHistogram::getPercentile(double percentile) const noexcept
+    {
+        if (_count == 0)
+        {
+            return DeltaTime(0);
+        }
+
+        const double rank = std::ceil(std::min(percentile, 100.0) / 100.0 * _count);
+        const uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(rank), 1);
+
+        uint64_t accumulated = 0;
+
+        for (uint32_t index = 0; index < BucketCount; ++index)
+        {
+            accumulated += _buckets[index];
+
+            if (accumulated >= target)
+            {
+                return fromMicroseconds(std::min(getBucketUpperBound(index), _maxMicroseconds));
+            }
+        }
+
+        return getMax();
+    }
+}
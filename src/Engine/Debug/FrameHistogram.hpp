@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <Engine/Common.hpp>
+
+namespace isc
+{
+    // Frame time histogram with log-linear buckets (HDR histogram style).
+    // Values are stored in microseconds: exact below 128us, then every power of
+    // two is split in 128 linear sub-buckets (<1% error) up to ~67s.
+    // Fixed size, never allocates.
+    class FrameHistogram
+    {
+    public:
+
+        static constexpr uint32_t SubBucketBits = 7;
+        static constexpr uint32_t SubBucketCount = 1u << SubBucketBits;
+        static constexpr uint32_t MaxValueBits = 26;
+        static constexpr uint32_t BucketCount = (MaxValueBits - SubBucketBits + 1) * SubBucketCount;
+
+        explicit FrameHistogram(DeltaTime budget = DeltaTime(1000.0 / 60.0));
+
+        void record(DeltaTime frameTime) noexcept;
+        void reset() noexcept;
+
+        uint64_t getCount() const noexcept;
+        uint64_t getOverBudgetCount() const noexcept;
+        DeltaTime getBudget() const noexcept;
+
+        DeltaTime getMin() const noexcept;
+        DeltaTime getMax() const noexcept;
+        DeltaTime getMean() const noexcept;
+
+        // percentile in [0, 100], returns the upper bound of the bucket
+        DeltaTime getPercentile(double percentile) const noexcept;
+
+    private:
+
+        std::array<uint32_t, BucketCount> _buckets;
+        uint64_t _count;
+        uint64_t _overBudgetCount;
+        uint64_t _totalMicroseconds;
+        uint64_t _minMicroseconds;
+        uint64_t _maxMicroseconds;
+        DeltaTime _budget;
+
+        static uint32_t getBucketIndex(uint64_t microseconds) noexcept;
+        static uint64_t getBucketUpperBound(uint32_t index) noexcept;
+    };
+}
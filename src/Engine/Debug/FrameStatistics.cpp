@@ -0,0 +1,79 @@
+#include "FrameStatistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace isc
+{
+    FrameStatistics::FrameStatistics(size_t expectedFrames)
+        : _total(0)
+        , _sorted(false)
+    {
+        _frameTimes.reserve(expectedFrames);
+    }
+
+    void FrameStatistics::record(DeltaTime frameTime)
+    {
+        _frameTimes.push_back(frameTime);
+        _total += frameTime;
+        _sorted = false;
+    }
+
+    size_t FrameStatistics::getCount() const noexcept
+    {
+        return _frameTimes.size();
+    }
+
+    DeltaTime FrameStatistics::getTotal() const noexcept
+    {
+        return _total;
+    }
+
+    DeltaTime FrameStatistics::getMean() const noexcept
+    {
+        return _frameTimes.empty()
+            ? DeltaTime(0)
+            : _total / static_cast<double>(_frameTimes.size());
+    }
+
+    DeltaTime FrameStatistics::getPercentile(double percentile) const
+    {
+        if (_frameTimes.empty())
+        {
+            return DeltaTime(0);
+        }
+
+        if (!_sorted)
+        {
+            _sortedFrameTimes = _frameTimes;
+            std::sort(_sortedFrameTimes.begin(), _sortedFrameTimes.end());
+            _sorted = true;
+        }
+
+        // nearest-rank
+        const double rank = std::ceil(percentile / 100.0 * _sortedFrameTimes.size());
+        const size_t index = static_cast<size_t>(std::max(rank, 1.0)) - 1;
+
+        return _sortedFrameTimes[std::min(index, _sortedFrameTimes.size() - 1)];
+    }
+
+    void FrameStatistics::report(std::ostream& output) const
+    {
+        const double seconds = _total.count() / 1000.0;
+        const double fps = seconds > 0 ? getCount() / seconds : 0;
+
+        output << std::fixed << std::setprecision(3)
+            << "[Benchmark] " << getCount() << " frames in " << seconds << "s (" << fps << " fps)" << std::endl
+            << "[Benchmark] frame time (ms):"
+            << " min " << getPercentile(0).count()
+            << " mean " << getMean().count()
+            << " p50 " << getPercentile(50).count()
+            << " p90 " << getPercentile(90).count()
+            << " p99 " << getPercentile(99).count()
+            << " max " << getPercentile(100).count()
+            << std::endl;
+
+        output << std::defaultfloat;
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+#include <Engine/Common.hpp>
+
+namespace isc
+{
+    // Keeps every recorded frame time, meant for finite benchmark runs
+    class FrameStatistics
+    {
+    public:
+
+        explicit FrameStatistics(size_t expectedFrames = 0);
+
+        void record(DeltaTime frameTime);
+
+        size_t getCount() const noexcept;
+        DeltaTime getTotal() const noexcept;
+        DeltaTime getMean() const noexcept;
+
+        // percentile in [0, 100]
+        DeltaTime getPercentile(double percentile) const;
+
+        void report(std::ostream& output) const;
+
+    private:
+
+        std::vector<DeltaTime> _frameTimes;
+        DeltaTime _total;
+        mutable bool _sorted;
+
+        mutable std::vector<DeltaTime> _sortedFrameTimes;
+    };
+}
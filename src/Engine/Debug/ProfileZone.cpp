@@ -0,0 +1,120 @@
+#ifdef ISC_PROFILE
+
+#include "ProfileZone.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace isc
+{
+    namespace profile
+    {
+        constexpr uint32_t ThreadBuffer::Capacity;
+
+        namespace
+        {
+            // buffers live until the end of the program, threads may finish before the dump
+            struct Registry
+            {
+                std::mutex mutex;
+                std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+            };
+
+            Registry& getRegistry()
+            {
+                static Registry registry;
+                return registry;
+            }
+
+            void writeEscaped(std::ostream& output, const char* text)
+            {
+                for (; *text != '\0'; ++text)
+                {
+                    if (*text == '"' || *text == '\\')
+                    {
+                        output << '\\';
+                    }
+
+                    output << *text;
+                }
+            }
+        }
+
+        ThreadBuffer::ThreadBuffer(uint32_t threadId)
+            : _threadId(threadId)
+            , _writeIndex(0)
+        {
+        }
+
+        void ThreadBuffer::write(std::ostream& output, bool& first) const
+        {
+            const uint64_t end = _writeIndex.load(std::memory_order_acquire);
+            const uint64_t begin = end > Capacity ? end - Capacity : 0;
+
+            for (uint64_t index = begin; index < end; ++index)
+            {
+                const ZoneEvent& event = _events[index & (Capacity - 1)];
+
+                output << (first ? "\n" : ",\n") << R"({"name":")";
+                writeEscaped(output, event.name);
+                output << R"(","cat":"cpu","ph":"X","pid":0,"tid":)" << _threadId
+                    << R"(,"ts":)" << event.start / 1000.0
+                    << R"(,"dur":)" << (event.end - event.start) / 1000.0
+                    << R"(,"args":{"depth":)" << event.depth << "}}";
+
+                first = false;
+            }
+        }
+
+        ThreadBuffer* registerThreadBuffer()
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+
+            const auto threadId = static_cast<uint32_t>(registry.buffers.size());
+            registry.buffers.emplace_back(new ThreadBuffer(threadId));
+
+            return registry.buffers.back().get();
+        }
+
+        void writeChromeTrace(std::ostream& output)
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+
+            bool first = true;
+
+            output << std::fixed << std::setprecision(3) << R"({"displayTimeUnit":"ms","traceEvents":[)";
+
+            for (const auto& buffer : registry.buffers)
+            {
+                buffer->write(output, first);
+            }
+
+            output << "\n]}\n";
+        }
+
+        bool saveChromeTrace(const char* path)
+        {
+            std::ofstream file(path);
+
+            if (!file)
+            {
+                std::cout << "[Profiler] Unable to write " << path << std::endl;
+                return false;
+            }
+
+            writeChromeTrace(file);
+
+            std::cout << "[Profiler] Trace saved to " << path << std::endl;
+            return true;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,121 @@
+#pragma once
+
+// Scoped CPU profiling zones:
+//
+//     ISC_PROFILE_SCOPE("render.overlay");
+//
+// Each zone is recorded, when its scope ends, into a ring buffer owned by the
+// current thread, and all of them can be saved as a Chrome trace
+// (chrome://tracing, https://ui.perfetto.dev) with ISC_PROFILE_DUMP(path).
+// Only compiled when ISC_PROFILE is defined: everything disappears otherwise.
+
+#ifdef ISC_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace isc
+{
+    namespace profile
+    {
+        struct ZoneEvent
+        {
+            const char* name;
+            uint64_t start;     // ns
+            uint64_t end;       // ns
+            uint32_t depth;
+        };
+
+        // Single producer (the owning thread), readable from any thread
+        class ThreadBuffer
+        {
+        public:
+
+            static constexpr uint32_t Capacity = 1u << 16;
+
+            explicit ThreadBuffer(uint32_t threadId);
+
+            // nesting level of the zone being opened
+            uint32_t depth = 0;
+
+            void push(const ZoneEvent& event) noexcept
+            {
+                // the oldest events get overwritten when full
+                const uint64_t index = _writeIndex.load(std::memory_order_relaxed);
+                _events[index & (Capacity - 1)] = event;
+                _writeIndex.store(index + 1, std::memory_order_release);
+            }
+
+            // events being written while dumping may appear torn, dump between frames
+            void write(std::ostream& output, bool& first) const;
+
+        private:
+
+            uint32_t _threadId;
+            std::atomic<uint64_t> _writeIndex;
+            ZoneEvent _events[Capacity];
+        };
+
+        ThreadBuffer* registerThreadBuffer();
+
+        inline ThreadBuffer& getThreadBuffer()
+        {
+            thread_local ThreadBuffer* buffer = registerThreadBuffer();
+            return *buffer;
+        }
+
+        inline uint64_t now() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        class Zone
+        {
+        public:
+
+            explicit Zone(const char* name)
+                : _buffer(getThreadBuffer())
+                , _name(name)
+                , _depth(_buffer.depth++)
+                , _start(now())
+            {
+            }
+
+            ~Zone()
+            {
+                _buffer.push({ _name, _start, now(), _depth });
+                --_buffer.depth;
+            }
+
+            Zone(const Zone&) = delete;
+            Zone& operator=(const Zone&) = delete;
+
+        private:
+
+            ThreadBuffer& _buffer;
+            const char* _name;
+            uint32_t _depth;
+            uint64_t _start;
+        };
+
+        // Chrome trace_event JSON, with the events still present in every thread buffer
+        void writeChromeTrace(std::ostream& output);
+        bool saveChromeTrace(const char* path);
+    }
+}
+
+#define ISC_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ISC_PROFILE_CONCAT(a, b) ISC_PROFILE_CONCAT_IMPL(a, b)
+
+#define ISC_PROFILE_SCOPE(name) isc::profile::Zone ISC_PROFILE_CONCAT(_profileZone, __LINE__)(name)
+#define ISC_PROFILE_DUMP(path) isc::profile::saveChromeTrace(path)
+
+#else
+
+#define ISC_PROFILE_SCOPE(name) do {} while (false)
+#define ISC_PROFILE_DUMP(path) do {} while (false)
+
+#endif
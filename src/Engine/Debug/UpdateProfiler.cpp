@@ -6,9 +6,15 @@
 
 namespace isc
 {
-    UpdateProfiler::UpdateProfiler()
+    UpdateProfiler::UpdateProfiler(DeltaTime frameBudget)
         : _deltaTotal(0)
         , _tickCount(0)
+        , _uploadedBytes(0)
+        , _issuedStateChanges(0)
+        , _elidedStateChanges(0)
+        , _consoleOutput(true)
+        , _histogram(frameBudget)
+        , _totalHistogram(frameBudget)
     {
     }
 
@@ -17,24 +23,91 @@ namespace isc
         _deltaTotal += deltaTime;
         ++_tickCount;
 
+        _histogram.record(deltaTime);
+        _totalHistogram.record(deltaTime);
+
         report();
     }
 
+    void UpdateProfiler::addUploadedBytes(size_t bytes)
+    {
+        _uploadedBytes += bytes;
+    }
+
+    void UpdateProfiler::addStateChanges(uint64_t issued, uint64_t elided)
+    {
+        _issuedStateChanges += issued;
+        _elidedStateChanges += elided;
+    }
+
     void UpdateProfiler::report()
     {
         using namespace std::chrono_literals;
 
         if (_deltaTotal >= 1s)
         {
-            auto average = _deltaTotal / _tickCount;
+            _lastReport.tickCount = _tickCount;
+            _lastReport.mean = _deltaTotal / _tickCount;
+            _lastReport.p50 = _histogram.getPercentile(50);
+            _lastReport.p90 = _histogram.getPercentile(90);
+            _lastReport.p99 = _histogram.getPercentile(99);
+            _lastReport.p999 = _histogram.getPercentile(99.9);
+            _lastReport.max = _histogram.getMax();
+            _lastReport.overBudgetCount = _histogram.getOverBudgetCount();
+            _lastReport.uploadedBytes = _uploadedBytes;
+            _lastReport.issuedStateChanges = _issuedStateChanges;
+            _lastReport.elidedStateChanges = _elidedStateChanges;
+
+            if (_consoleOutput)
+            {
+                auto uploadedPerTick = static_cast<double>(_uploadedBytes) / _tickCount / 1024.0;
+
+                std::cout << "[Profiler] "
+                    << _tickCount << " fps (~"
+                    << std::setprecision(3) << _lastReport.mean.count() << "ms, "
+                    << std::setprecision(4) << uploadedPerTick << "KB/frame uploaded, "
+                    << _issuedStateChanges / _tickCount << " GL state calls/frame, "
+                    << _elidedStateChanges / _tickCount << " elided)"
+                    << std::endl;
 
-            std::cout << "[Profiler] "
-                << _tickCount << " fps (~"
-                << std::setprecision(3) << average.count() << "ms)"
-                << std::endl;
+                std::cout << "[Profiler] "
+                    << std::setprecision(3)
+                    << "p50 " << _lastReport.p50.count() << "ms"
+                    << ", p90 " << _lastReport.p90.count() << "ms"
+                    << ", p99 " << _lastReport.p99.count() << "ms"
+                    << ", p99.9 " << _lastReport.p999.count() << "ms"
+                    << ", max " << _lastReport.max.count() << "ms"
+                    << ", " << _lastReport.overBudgetCount << " over "
+                    << _histogram.getBudget().count() << "ms"
+                    << std::endl;
+            }
 
             _deltaTotal = 0ms;
             _tickCount = 0;
+            _uploadedBytes = 0;
+            _issuedStateChanges = 0;
+            _elidedStateChanges = 0;
+            _histogram.reset();
         }
     }
+
+    void UpdateProfiler::setConsoleOutput(bool enabled) noexcept
+    {
+        _consoleOutput = enabled;
+    }
+
+    const FrameHistogram& UpdateProfiler::getHistogram() const noexcept
+    {
+        return _histogram;
+    }
+
+    const FrameHistogram& UpdateProfiler::getTotalHistogram() const noexcept
+    {
+        return _totalHistogram;
+    }
+
+    const ProfilerReport& UpdateProfiler::getLastReport() const noexcept
+    {
+        return _lastReport;
+    }
 }
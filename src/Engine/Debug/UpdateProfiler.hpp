@@ -1,20 +1,60 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include <Engine/Common.hpp>
+#include <Engine/Debug/FrameHistogram.hpp>
 
 namespace isc
 {
+    // Summary of the last completed reporting period (~1 second)
+    struct ProfilerReport
+    {
+        size_t tickCount = 0;
+        DeltaTime mean = DeltaTime(0);
+        DeltaTime p50 = DeltaTime(0);
+        DeltaTime p90 = DeltaTime(0);
+        DeltaTime p99 = DeltaTime(0);
+        DeltaTime p999 = DeltaTime(0);
+        DeltaTime max = DeltaTime(0);
+        uint64_t overBudgetCount = 0;
+        size_t uploadedBytes = 0;
+        uint64_t issuedStateChanges = 0;
+        uint64_t elidedStateChanges = 0;
+    };
+
     class UpdateProfiler
     {
     public:
 
-        UpdateProfiler();
+        explicit UpdateProfiler(DeltaTime frameBudget = DeltaTime(1000.0 / 60.0));
         void update(DeltaTime deltaTime);
+        void addUploadedBytes(size_t bytes);
+        void addStateChanges(uint64_t issued, uint64_t elided);
         void report();
 
+        void setConsoleOutput(bool enabled) noexcept;
+
+        // frames of the current period
+        const FrameHistogram& getHistogram() const noexcept;
+
+        // frames since the profiler was created
+        const FrameHistogram& getTotalHistogram() const noexcept;
+
+        const ProfilerReport& getLastReport() const noexcept;
+
     private:
 
         DeltaTime _deltaTotal;
         size_t _tickCount;
+        size_t _uploadedBytes;
+        uint64_t _issuedStateChanges;
+        uint64_t _elidedStateChanges;
+        bool _consoleOutput;
+
+        FrameHistogram _histogram;
+        FrameHistogram _totalHistogram;
+        ProfilerReport _lastReport;
     };
 }
@@ -0,0 +1,68 @@
+#include "FixedTimestep.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include <Engine/Exceptions/RuntimeException.hpp>
+
+namespace isc
+{
+    FixedTimestep::FixedTimestep(const FixedTimestepSettings& settings)
+        : _settings(settings)
+        , _step(1000.0 / settings.tickRate)
+        , _accumulator(0)
+        , _droppedSteps(0)
+    {
+        // negated so NaN is rejected too
+        if (!(settings.tickRate > 0))
+        {
+            throw RuntimeException("Invalid fixed timestep tick rate", std::to_string(settings.tickRate));
+        }
+
+        if (settings.maxStepsPerFrame == 0)
+        {
+            throw RuntimeException("Invalid fixed timestep step limit", "maxStepsPerFrame must be greater than 0");
+        }
+    }
+
+    uint32_t FixedTimestep::advance(DeltaTime frameTime)
+    {
+        _accumulator += std::min(frameTime, _settings.maxFrameTime);
+
+        const auto pendingSteps = static_cast<uint64_t>(_accumulator / _step);
+        const auto steps = static_cast<uint32_t>(std::min<uint64_t>(pendingSteps, _settings.maxStepsPerFrame));
+
+        _accumulator -= _step * steps;
+
+        if (pendingSteps > steps)
+        {
+            const DeltaTime maxBacklog = _settings.overrunPolicy == OverrunPolicy::CatchUp
+                ? _step * _settings.maxStepsPerFrame
+                : DeltaTime(0);
+
+            // keep the fraction of a step, so alpha stays continuous
+            const DeltaTime fraction = _accumulator - _step * static_cast<uint64_t>(_accumulator / _step);
+            const DeltaTime kept = std::min(_accumulator - fraction, maxBacklog) + fraction;
+
+            _droppedSteps += static_cast<uint64_t>((_accumulator - kept) / _step);
+            _accumulator = kept;
+        }
+
+        return steps;
+    }
+
+    DeltaTime FixedTimestep::getStep() const noexcept
+    {
+        return _step;
+    }
+
+    double FixedTimestep::getAlpha() const noexcept
+    {
+        return std::min(_accumulator / _step, 1.0);
+    }
+
+    uint64_t FixedTimestep::getDroppedSteps() const noexcept
+    {
+        return _droppedSteps;
+    }
+}
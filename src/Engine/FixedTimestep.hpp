@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+#include <Engine/Common.hpp>
+
+namespace isc
+{
+    // What to do with the time that couldn't be simulated because
+    // a frame needed more than maxStepsPerFrame updates
+    enum class OverrunPolicy
+    {
+        DropTime,   // forget it: the simulation runs slower than real time, but never falls behind
+        CatchUp,    // keep up to maxStepsPerFrame steps of backlog and recover during the next frames
+    };
+
+    struct FixedTimestepSettings
+    {
+        double tickRate = 60.0;                             // updates per second
+        uint32_t maxStepsPerFrame = 5;                      // spiral-of-death protection
+        DeltaTime maxFrameTime = DeltaTime(250.0);          // breakpoints, tab switches, window drags...
+        OverrunPolicy overrunPolicy = OverrunPolicy::DropTime;
+    };
+
+    // Accumulator that splits variable frame times into constant simulation steps
+    class FixedTimestep
+    {
+    public:
+
+        explicit FixedTimestep(const FixedTimestepSettings& settings);
+
+        // returns how many steps must be simulated for this frame
+        uint32_t advance(DeltaTime frameTime);
+
+        DeltaTime getStep() const noexcept;
+
+        // progress [0, 1) between the last simulated step and the next one,
+        // used to interpolate the rendered state
+        double getAlpha() const noexcept;
+
+        // steps lost because of the overrun policy since the beginning
+        uint64_t getDroppedSteps() const noexcept;
+
+    private:
+
+        FixedTimestepSettings _settings;
+        DeltaTime _step;
+        DeltaTime _accumulator;
+        uint64_t _droppedSteps;
+    };
+}
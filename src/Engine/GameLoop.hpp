@@ -2,27 +2,34 @@
 
 #include <memory>
 #include <chrono>
+#include <functional>
+#include <iostream>
 
 #include <Engine/Common.hpp>
+#include <Engine/FixedTimestep.hpp>
+#include <Engine/Debug/FrameStatistics.hpp>
 #include <Engine/Integrations/Emscripten.hpp>
+#include <Engine/Jobs/JobSystem.hpp>
+#include <Engine/Jobs/TripleBuffer.hpp>
+#include <Engine/Memory/FrameArena.hpp>
 
-template<typename TGameContext, typename... TArgs>
-constexpr int initGameLoop(TArgs&&... args)
+// Calls frame(deltaTime) once per displayed frame until it returns false
+template<typename TGameContext, typename TFrame>
+void runMainLoop(std::unique_ptr<TGameContext>& context, TFrame& frame)
 {
-    auto context = std::make_unique<TGameContext>(std::forward<TArgs>(args)...);
-    context->init();
-
     auto previousTime = std::chrono::steady_clock::now();
     DeltaTime deltaTime = std::chrono::nanoseconds(0);
 
 #ifdef __EMSCRIPTEN__
     auto loopCallback = [&]() -> void
     {
+        isc::FrameArena::beginFrame();
+
         auto newTime = std::chrono::steady_clock::now();
         deltaTime = newTime - previousTime;
         previousTime = newTime;
 
-        if (!context->loop(deltaTime))
+        if (!frame(deltaTime))
         {
             context.reset();
             emscripten_cancel_main_loop();
@@ -36,14 +43,187 @@ constexpr int initGameLoop(TArgs&&... args)
 #else
     do
     {
+        isc::FrameArena::beginFrame();
+
         auto newTime = std::chrono::steady_clock::now();
         deltaTime = newTime - previousTime;
         previousTime = newTime;
     }
-    while (context->loop(deltaTime));
+    while (frame(deltaTime));
 
     context.reset();
 #endif
+}
+
+// Variable step: context->loop(deltaTime) once per frame
+template<typename TGameContext, typename... TArgs>
+constexpr int initGameLoop(TArgs&&... args)
+{
+    auto context = std::make_unique<TGameContext>(std::forward<TArgs>(args)...);
+    context->init();
+
+    auto frame = [&](DeltaTime deltaTime) -> bool
+    {
+        return context->loop(deltaTime);
+    };
+
+    runMainLoop(context, frame);
+
+    return 0;
+}
+
+// Fixed step: context->update(step) at settings.tickRate, then
+// context->render(deltaTime, alpha) once per frame, alpha being the
+// interpolation factor between the last two simulated states
+template<typename TGameContext, typename... TArgs>
+constexpr int initFixedGameLoop(const isc::FixedTimestepSettings& settings, TArgs&&... args)
+{
+    auto context = std::make_unique<TGameContext>(std::forward<TArgs>(args)...);
+    context->init();
+
+    isc::FixedTimestep timestep(settings);
+
+    auto frame = [&](DeltaTime deltaTime) -> bool
+    {
+        const uint32_t steps = timestep.advance(deltaTime);
+
+        for (uint32_t i = 0; i < steps; ++i)
+        {
+            if (!context->update(timestep.getStep()))
+            {
+                return false;
+            }
+        }
+
+        context->render(deltaTime, timestep.getAlpha());
+
+        return true;
+    };
+
+    runMainLoop(context, frame);
+
+    return 0;
+}
+
+namespace isc
+{
+    template<typename TSnapshot>
+    struct PipelinedFrame
+    {
+        TSnapshot snapshot;
+        double alpha = 0.0;
+    };
+}
+
+// Pipelined fixed step: frame N+1 is simulated on a worker while the main thread
+// submits the snapshot of frame N to GL. The context provides:
+// - Snapshot: everything render() reads
+// - input(): events, on the main thread before the simulation starts, false to quit
+// - simulate(step): at settings.tickRate on the worker, no GL or window calls, false to quit
+// - extract(snapshot): on the worker after the steps of the frame
+// - render(snapshot, deltaTime, alpha): on the main thread
+// The worker owns the simulation state from the start of the job until the end of the
+// frame, the snapshots are handed over through a triple buffer: what gets rendered is
+// always one frame behind. Without workers (single threaded wasm) the simulation runs
+// first, then the previous snapshot is rendered: same latency, no overlap.
+template<typename TGameContext, typename... TArgs>
+int initPipelinedGameLoop(isc::jobs::JobSystem& jobs, const isc::FixedTimestepSettings& settings, TArgs&&... args)
+{
+    auto context = std::make_unique<TGameContext>(std::forward<TArgs>(args)...);
+    context->init();
+
+    isc::FixedTimestep timestep(settings);
+    isc::jobs::TripleBuffer<isc::PipelinedFrame<typename TGameContext::Snapshot>> frames;
+    isc::jobs::Counter simulation;
+    bool running = true;
+
+    // written by the main thread before the job is scheduled
+    uint32_t steps = 0;
+    double alpha = 0.0;
+
+    auto simulate = [&]()
+    {
+        for (uint32_t i = 0; i < steps && running; ++i)
+        {
+            running = context->simulate(timestep.getStep());
+        }
+
+        auto& next = frames.getWriteBuffer();
+        context->extract(next.snapshot);
+        next.alpha = alpha;
+
+        frames.publish();
+    };
+
+    auto frame = [&](DeltaTime deltaTime) -> bool
+    {
+        if (!context->input())
+        {
+            return false;
+        }
+
+        steps = timestep.advance(deltaTime);
+        alpha = timestep.getAlpha();
+
+        // taken before the job starts: never the frame being simulated, even if it's done before the render
+        const auto* previous = frames.acquire();
+
+        // std::function stores a reference_wrapper inline: no allocation per frame
+        jobs.run(std::ref(simulate), simulation);
+
+        // nobody else would run it, and it shouldn't run from the middle of render() (executeMainThreadJobs)
+        if (jobs.getWorkerCount() == 0)
+        {
+            jobs.wait(simulation);
+        }
+
+        if (previous != nullptr)
+        {
+            context->render(previous->snapshot, deltaTime, previous->alpha);
+        }
+
+        // the simulation state belongs to the main thread again until the next frame
+        jobs.wait(simulation);
+
+        return running;
+    };
+
+    runMainLoop(context, frame);
+
+    return 0;
+}
+
+// Benchmark: runs `frames` frames as fast as possible, each one simulating a
+// single step, and prints the frame time statistics. The amount of work per
+// frame doesn't depend on the machine speed, so runs can be compared.
+template<typename TGameContext, typename... TArgs>
+int initBenchmarkLoop(size_t frames, const isc::FixedTimestepSettings& settings, TArgs&&... args)
+{
+    auto context = std::make_unique<TGameContext>(std::forward<TArgs>(args)...);
+    context->init();
+
+    const DeltaTime step(1000.0 / settings.tickRate);
+    isc::FrameStatistics statistics(frames);
+
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        isc::FrameArena::beginFrame();
+
+        auto startTime = std::chrono::steady_clock::now();
+
+        if (!context->update(step))
+        {
+            break;
+        }
+
+        context->render(step, 0.0);
+
+        statistics.record(std::chrono::steady_clock::now() - startTime);
+    }
+
+    context.reset();
+
+    statistics.report(std::cout);
 
     return 0;
 }
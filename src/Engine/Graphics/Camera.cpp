@@ -0,0 +1,162 @@
+#include "Camera.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace isc
+{
+    void Frustum::extract(const glm::mat4& viewProjection) noexcept
+    {
+        // Gribb & Hartmann: rows of the view projection, glm matrices are column major
+        const glm::mat4 m = glm::transpose(viewProjection);
+
+        planes[Left] = m[3] + m[0];
+        planes[Right] = m[3] - m[0];
+        planes[Bottom] = m[3] + m[1];
+        planes[Top] = m[3] - m[1];
+        planes[Near] = m[3] + m[2];
+        planes[Far] = m[3] - m[2];
+
+        for (glm::vec4& plane : planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+    }
+
+    bool Frustum::isVisible(const glm::vec3& center, float radius) const noexcept
+    {
+        for (const glm::vec4& plane : planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    Camera::Camera(float fovY, float zNear, float zFar)
+        : _fovY(fovY)
+        , _near(zNear)
+        , _far(zFar)
+        , _aspect(1.f)
+        , _eye(0.f, 0.f, 1.f)
+        , _target(0.f)
+        , _up(0.f, 1.f, 0.f)
+        , _view(1.f)
+        , _projection(1.f)
+        , _viewProjection(1.f)
+        , _viewDirty(true)
+        , _projectionDirty(true)
+    {
+    }
+
+    void Camera::setPerspective(float fovY, float zNear, float zFar) noexcept
+    {
+        if (fovY != _fovY || zNear != _near || zFar != _far)
+        {
+            _fovY = fovY;
+            _near = zNear;
+            _far = zFar;
+            _projectionDirty = true;
+        }
+    }
+
+    void Camera::setViewportSize(const vec2<uint32_t>& size) noexcept
+    {
+        if (size.x == 0 || size.y == 0)
+        {
+            return;
+        }
+
+        const float aspect = static_cast<float>(size.x) / static_cast<float>(size.y);
+
+        if (aspect != _aspect)
+        {
+            _aspect = aspect;
+            _projectionDirty = true;
+        }
+    }
+
+    void Camera::lookAt(const glm::vec3& eye, const glm::vec3& target, const glm::vec3& up) noexcept
+    {
+        if (eye != _eye || target != _target || up != _up)
+        {
+            _eye = eye;
+            _target = target;
+            _up = up;
+            _viewDirty = true;
+        }
+    }
+
+    bool Camera::handleEvent(const SDL_Event& event) noexcept
+    {
+        if (event.type != SDL_WINDOWEVENT)
+        {
+            return false;
+        }
+
+        switch (event.window.event)
+        {
+            case SDL_WINDOWEVENT_RESIZED:
+            case SDL_WINDOWEVENT_SIZE_CHANGED:
+            {
+                setViewportSize({ static_cast<uint32_t>(event.window.data1), static_cast<uint32_t>(event.window.data2) });
+                return true;
+            }
+
+            default: return false;
+        }
+    }
+
+    bool Camera::update() noexcept
+    {
+        if (!_viewDirty && !_projectionDirty)
+        {
+            return false;
+        }
+
+        if (_projectionDirty)
+        {
+            _projection = glm::perspective(glm::radians(_fovY), _aspect, _near, _far);
+        }
+
+        if (_viewDirty)
+        {
+            _view = glm::lookAt(_eye, _target, _up);
+        }
+
+        _viewProjection = _projection * _view;
+        _frustum.extract(_viewProjection);
+
+        _viewDirty = false;
+        _projectionDirty = false;
+
+        return true;
+    }
+
+    const glm::mat4& Camera::getView() const noexcept
+    {
+        return _view;
+    }
+
+    const glm::mat4& Camera::getProjection() const noexcept
+    {
+        return _projection;
+    }
+
+    const glm::mat4& Camera::getViewProjection() const noexcept
+    {
+        return _viewProjection;
+    }
+
+    const Frustum& Camera::getFrustum() const noexcept
+    {
+        return _frustum;
+    }
+
+    const glm::vec3& Camera::getPosition() const noexcept
+    {
+        return _eye;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <SDL.h>
+#include <glm/glm.hpp>
+
+#include <Engine/Math/Vector.hpp>
+
+namespace isc
+{
+    // Planes point inwards: a point is inside if every plane gives a positive distance.
+    struct Frustum
+    {
+        enum PlaneIndex
+        {
+            Left,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            PlaneCount
+        };
+
+        std::array<glm::vec4, PlaneCount> planes; // xyz: unit normal, w: distance
+
+        void extract(const glm::mat4& viewProjection) noexcept;
+        bool isVisible(const glm::vec3& center, float radius) const noexcept;
+    };
+
+    // Projection and view are only rebuilt when something they depend on changed:
+    // - projection: window resizes (handleEvent) and setPerspective()
+    // - view: lookAt() with a different eye, target or up
+    // update() rebuilds what's dirty, then the view projection and the frustum if needed.
+    class Camera
+    {
+    public:
+
+        Camera(float fovY = 45.f, float zNear = 0.01f, float zFar = 1000.f);
+
+        // degrees
+        void setPerspective(float fovY, float zNear, float zFar) noexcept;
+        void setViewportSize(const vec2<uint32_t>& size) noexcept;
+        void lookAt(const glm::vec3& eye, const glm::vec3& target, const glm::vec3& up = glm::vec3(0.f, 1.f, 0.f)) noexcept;
+
+        // window resizes, same events as Window::handleEvent
+        bool handleEvent(const SDL_Event& event) noexcept;
+
+        // true if any matrix changed since the last call
+        bool update() noexcept;
+
+        const glm::mat4& getView() const noexcept;
+        const glm::mat4& getProjection() const noexcept;
+        const glm::mat4& getViewProjection() const noexcept;
+        const Frustum& getFrustum() const noexcept;
+        const glm::vec3& getPosition() const noexcept;
+
+    private:
+
+        float _fovY;
+        float _near;
+        float _far;
+        float _aspect;
+
+        glm::vec3 _eye;
+        glm::vec3 _target;
+        glm::vec3 _up;
+
+        glm::mat4 _view;
+        glm::mat4 _projection;
+        glm::mat4 _viewProjection;
+        Frustum _frustum;
+
+        bool _viewDirty;
+        bool _projectionDirty;
+    };
+}
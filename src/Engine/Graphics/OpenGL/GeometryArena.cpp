@@ -0,0 +1,377 @@
+#include "GeometryArena.hpp"
+
+#include <algorithm>
+
+#include <Engine/Exceptions/RuntimeException.hpp>
+#include <Engine/Graphics/OpenGL/MeshBuilder.hpp>
+
+#if defined(__EMSCRIPTEN__) && defined(__has_include)
+    #if __has_include(<webgl/webgl1_ext.h>)
+        #include <webgl/webgl1_ext.h>
+        #define ISC_WEBGL_MULTI_DRAW
+    #endif
+#endif
+
+namespace isc
+{
+    namespace gl
+    {
+        namespace
+        {
+            uint32_t getIndexSize(GLenum indexType)
+            {
+                switch (indexType)
+                {
+                    case GL_UNSIGNED_BYTE: return 1;
+                    case GL_UNSIGNED_SHORT: return 2;
+                    case GL_UNSIGNED_INT: return 4;
+                    default: throw RuntimeException("Invalid index type", std::to_string(indexType));
+                }
+            }
+
+            bool isSameLayout(const VertexLayout& a, const VertexLayout& b)
+            {
+                if (a.stride != b.stride || a.attributes.size() != b.attributes.size())
+                {
+                    return false;
+                }
+
+                for (size_t i = 0; i < a.attributes.size(); ++i)
+                {
+                    const VertexAttribute& x = a.attributes[i];
+                    const VertexAttribute& y = b.attributes[i];
+
+                    if (x.location != y.location || x.components != y.components || x.type != y.type
+                        || x.normalized != y.normalized || x.offset != y.offset)
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            uint64_t getMaxVertices(uint32_t indexSize)
+            {
+                return std::min<uint64_t>(uint64_t(1) << (8 * indexSize), UINT32_MAX);
+            }
+        }
+
+        GeometryArena::GeometryArena(const VertexLayout& layout, uint32_t vertexCapacity, uint32_t indexCapacity, GLenum indexType)
+            : _layout(layout)
+            , _indexType(indexType)
+            , _indexSize(getIndexSize(indexType))
+            , _vao(0)
+            , _vertexBuffer(0)
+            , _indexBuffer(0)
+            , _vertices(static_cast<uint32_t>(std::min<uint64_t>(vertexCapacity, getMaxVertices(_indexSize))))
+            , _indices(indexCapacity)
+            , _multiDrawElements(nullptr)
+            , _multiDrawArrays(nullptr)
+        {
+        }
+
+        GeometryArena::~GeometryArena()
+        {
+            if (_vao != 0)
+            {
+                glDeleteVertexArrays(1, &_vao);
+                glDeleteBuffers(1, &_vertexBuffer);
+                glDeleteBuffers(1, &_indexBuffer);
+            }
+        }
+
+        void GeometryArena::init(StateCache& state)
+        {
+            GL(glGenVertexArrays(1, &_vao));
+            GL(glGenBuffers(1, &_vertexBuffer));
+            GL(glGenBuffers(1, &_indexBuffer));
+
+            state.bindVertexArray(_vao);
+
+            state.bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+            GL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(_vertices.getCapacity()) * _layout.stride, nullptr, GL_STATIC_DRAW));
+            setAttributes(state);
+
+            // the element array binding is recorded in the VAO
+            state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+            GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(_indices.getCapacity()) * _indexSize, nullptr, GL_STATIC_DRAW));
+
+#if defined(ISC_WEBGL_MULTI_DRAW)
+            if (hasExtension("WEBGL_multi_draw"))
+            {
+                _multiDrawElements = glMultiDrawElementsWEBGL;
+                _multiDrawArrays = glMultiDrawArraysWEBGL;
+            }
+#elif !defined(__EMSCRIPTEN__)
+            if (hasExtension("GL_EXT_multi_draw_arrays"))
+            {
+                _multiDrawElements = reinterpret_cast<MultiDrawElements>(getProcAddress("glMultiDrawElementsEXT"));
+                _multiDrawArrays = reinterpret_cast<MultiDrawArrays>(getProcAddress("glMultiDrawArraysEXT"));
+            }
+#endif
+        }
+
+        void GeometryArena::setAttributes(StateCache& state)
+        {
+            state.bindVertexArray(_vao);
+            state.bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+
+            for (const VertexAttribute& attribute : _layout.attributes)
+            {
+                GL(glEnableVertexAttribArray(attribute.location));
+                GL(glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized,
+                    static_cast<GLsizei>(_layout.stride), reinterpret_cast<const void*>(static_cast<size_t>(attribute.offset))));
+            }
+        }
+
+        void GeometryArena::grow(StateCache& state, RangeAllocator& allocator, GLuint& buffer, GLenum target, uint32_t elementSize, uint32_t capacity)
+        {
+            GLuint resized = 0;
+            GL(glGenBuffers(1, &resized));
+
+            // copied on the GPU, nothing comes back to the CPU
+            state.bindBuffer(GL_COPY_READ_BUFFER, buffer);
+            state.bindBuffer(GL_COPY_WRITE_BUFFER, resized);
+
+            GL(glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(capacity) * elementSize, nullptr, GL_STATIC_DRAW));
+            GL(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(allocator.getCapacity()) * elementSize));
+
+            GL(glDeleteBuffers(1, &buffer));
+            state.invalidateBuffers();
+
+            buffer = resized;
+            allocator.grow(capacity);
+
+            // the VAO still points to the old buffer
+            if (target == GL_ARRAY_BUFFER)
+            {
+                setAttributes(state);
+            }
+            else
+            {
+                state.bindVertexArray(_vao);
+                state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+            }
+        }
+
+        uint32_t GeometryArena::reserve(StateCache& state, RangeAllocator& allocator, GLuint& buffer, GLenum target, uint32_t elementSize, uint32_t count)
+        {
+            auto offset = allocator.allocate(count);
+
+            while (!offset)
+            {
+                uint64_t capacity = std::max<uint64_t>(uint64_t(allocator.getCapacity()) * 2, allocator.getCapacity() + count);
+
+                if (target == GL_ARRAY_BUFFER)
+                {
+                    const uint64_t maxVertices = getMaxVertices(_indexSize);
+
+                    if (allocator.getCapacity() == maxVertices)
+                    {
+                        throw RuntimeException("Geometry arena full", std::to_string(maxVertices) + " vertices, use a wider index type");
+                    }
+
+                    capacity = std::min(capacity, maxVertices);
+                }
+
+                grow(state, allocator, buffer, target, elementSize, static_cast<uint32_t>(capacity));
+                offset = allocator.allocate(count);
+            }
+
+            return offset.value();
+        }
+
+        MeshHandle GeometryArena::add(StateCache& state, const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+        {
+            MeshHandle mesh;
+
+            // nothing to allocate: an empty handle draws nothing and releases nothing
+            if (vertexCount == 0)
+            {
+                return mesh;
+            }
+
+            mesh.vertexCount = vertexCount;
+            mesh.baseVertex = reserve(state, _vertices, _vertexBuffer, GL_ARRAY_BUFFER, _layout.stride, vertexCount);
+
+            state.bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+            GL(glBufferSubData(GL_ARRAY_BUFFER,
+                static_cast<GLintptr>(mesh.baseVertex) * _layout.stride,
+                static_cast<GLsizeiptr>(vertexCount) * _layout.stride,
+                vertices));
+
+            if (indices == nullptr || indexCount == 0)
+            {
+                return mesh;
+            }
+
+            mesh.indexCount = indexCount;
+            mesh.firstIndex = reserve(state, _indices, _indexBuffer, GL_ELEMENT_ARRAY_BUFFER, _indexSize, indexCount);
+
+            // no base vertex in ES 3.0: the offset is baked into the indices
+            _rebasedIndices.resize(static_cast<size_t>(indexCount) * _indexSize);
+
+            for (uint32_t i = 0; i < indexCount; ++i)
+            {
+                const uint32_t index = indices[i] + mesh.baseVertex;
+
+                switch (_indexSize)
+                {
+                    case 1: _rebasedIndices[i] = static_cast<uint8_t>(index); break;
+                    case 2: reinterpret_cast<uint16_t*>(_rebasedIndices.data())[i] = static_cast<uint16_t>(index); break;
+                    default: reinterpret_cast<uint32_t*>(_rebasedIndices.data())[i] = index; break;
+                }
+            }
+
+            // the element array binding belongs to the VAO
+            state.bindVertexArray(_vao);
+            state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+
+            GL(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+                static_cast<GLintptr>(mesh.firstIndex) * _indexSize,
+                static_cast<GLsizeiptr>(_rebasedIndices.size()),
+                _rebasedIndices.data()));
+
+            return mesh;
+        }
+
+        MeshHandle GeometryArena::add(StateCache& state, const MeshData& mesh)
+        {
+            if (!isSameLayout(mesh.layout, _layout))
+            {
+                throw RuntimeException("Mesh doesn't match the geometry arena", "different vertex layout");
+            }
+
+            // rebased (and narrowed again if needed) by add()
+            _widenedIndices.resize(mesh.indexCount);
+
+            for (uint32_t i = 0; i < mesh.indexCount; ++i)
+            {
+                switch (mesh.indexType)
+                {
+                    case GL_UNSIGNED_BYTE: _widenedIndices[i] = mesh.indices[i]; break;
+                    case GL_UNSIGNED_SHORT: _widenedIndices[i] = reinterpret_cast<const uint16_t*>(mesh.indices.data())[i]; break;
+                    default: _widenedIndices[i] = reinterpret_cast<const uint32_t*>(mesh.indices.data())[i]; break;
+                }
+            }
+
+            return add(state, mesh.vertices.data(), mesh.vertexCount, _widenedIndices.data(), mesh.indexCount);
+        }
+
+        void GeometryArena::remove(const MeshHandle& mesh)
+        {
+            _vertices.release(mesh.baseVertex, mesh.vertexCount);
+            _indices.release(mesh.firstIndex, mesh.indexCount);
+        }
+
+        DrawCommand GeometryArena::makeCommand(const MeshHandle& mesh, ShaderProgram* program, GLenum mode) const noexcept
+        {
+            DrawCommand command;
+            command.program = program;
+            command.vao = _vao;
+            command.mode = mode;
+
+            if (mesh.isIndexed())
+            {
+                command.indexType = _indexType;
+                command.first = static_cast<GLint>(mesh.firstIndex);
+                command.count = static_cast<GLsizei>(mesh.indexCount);
+            }
+            else
+            {
+                command.indexType = GL_NONE;
+                command.first = static_cast<GLint>(mesh.baseVertex);
+                command.count = static_cast<GLsizei>(mesh.vertexCount);
+            }
+
+            return command;
+        }
+
+        void GeometryArena::drawMultiple(StateCache& state, const MeshHandle* meshes, size_t count, GLenum mode)
+        {
+            state.bindVertexArray(_vao);
+
+            _counts.clear();
+            _offsets.clear();
+
+            // indexed meshes
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (meshes[i].isIndexed())
+                {
+                    _counts.push_back(static_cast<GLsizei>(meshes[i].indexCount));
+                    _offsets.push_back(reinterpret_cast<const void*>(static_cast<size_t>(meshes[i].firstIndex) * _indexSize));
+                }
+            }
+
+            if (_multiDrawElements != nullptr && !_counts.empty())
+            {
+                GL(_multiDrawElements(mode, _counts.data(), _indexType, _offsets.data(), static_cast<GLsizei>(_counts.size())));
+            }
+            else
+            {
+                for (size_t i = 0; i < _counts.size(); ++i)
+                {
+                    GL(glDrawElements(mode, _counts[i], _indexType, _offsets[i]));
+                }
+            }
+
+            _counts.clear();
+            _firsts.clear();
+
+            // everything else
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!meshes[i].isIndexed())
+                {
+                    _counts.push_back(static_cast<GLsizei>(meshes[i].vertexCount));
+                    _firsts.push_back(static_cast<GLint>(meshes[i].baseVertex));
+                }
+            }
+
+            if (_multiDrawArrays != nullptr && !_counts.empty())
+            {
+                GL(_multiDrawArrays(mode, _firsts.data(), _counts.data(), static_cast<GLsizei>(_counts.size())));
+            }
+            else
+            {
+                for (size_t i = 0; i < _counts.size(); ++i)
+                {
+                    GL(glDrawArrays(mode, _firsts[i], _counts[i]));
+                }
+            }
+        }
+
+        bool GeometryArena::hasMultiDraw() const noexcept
+        {
+            return _multiDrawElements != nullptr;
+        }
+
+        GLuint GeometryArena::getVertexArray() const noexcept
+        {
+            return _vao;
+        }
+
+        GLenum GeometryArena::getIndexType() const noexcept
+        {
+            return _indexType;
+        }
+
+        size_t GeometryArena::getBytes(const MeshHandle& mesh) const noexcept
+        {
+            return static_cast<size_t>(mesh.vertexCount) * _layout.stride
+                + static_cast<size_t>(mesh.indexCount) * _indexSize;
+        }
+
+        const RangeAllocator& GeometryArena::getVertexAllocator() const noexcept
+        {
+            return _vertices;
+        }
+
+        const RangeAllocator& GeometryArena::getIndexAllocator() const noexcept
+        {
+            return _indices;
+        }
+    }
+}
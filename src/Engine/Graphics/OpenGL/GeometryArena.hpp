@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Engine/Graphics/RangeAllocator.hpp>
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Graphics/OpenGL/RenderQueue.hpp>
+#include <Engine/Graphics/OpenGL/StateCache.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        struct MeshData;
+
+        struct VertexAttribute
+        {
+            GLuint location;
+            GLint components;
+            GLenum type;
+            GLboolean normalized;
+            uint32_t offset;
+        };
+
+        struct VertexLayout
+        {
+            std::vector<VertexAttribute> attributes;
+            uint32_t stride;
+        };
+
+        // where a mesh lives inside the arena, in vertices and indices (not bytes)
+        struct MeshHandle
+        {
+            uint32_t baseVertex = 0;
+            uint32_t vertexCount = 0;
+            uint32_t firstIndex = 0;
+            uint32_t indexCount = 0;    // 0: not indexed
+
+            bool isIndexed() const noexcept { return indexCount > 0; }
+        };
+
+        // Every mesh with the same vertex layout shares one VAO, one vertex buffer and one index buffer.
+        // Ranges are sub-allocated from a free list, the buffers double (GPU side copy) when full.
+        //
+        // OpenGL ES 3.0 / WebGL 2.0 have no glDrawElementsBaseVertex: indices are rebased on upload,
+        // so an indexed draw only needs (firstIndex, indexCount).
+        class GeometryArena
+        {
+        public:
+
+            // 16 bit indices limit the arena to 65536 vertices
+            GeometryArena(const VertexLayout& layout, uint32_t vertexCapacity = 16384, uint32_t indexCapacity = 49152, GLenum indexType = GL_UNSIGNED_SHORT);
+            ~GeometryArena();
+
+            GeometryArena(const GeometryArena&) = delete;
+            GeometryArena& operator=(const GeometryArena&) = delete;
+
+            // requires a current GL context
+            void init(StateCache& state);
+
+            MeshHandle add(StateCache& state, const void* vertices, uint32_t vertexCount, const uint32_t* indices = nullptr, uint32_t indexCount = 0);
+
+            // the mesh layout has to match the arena layout
+            MeshHandle add(StateCache& state, const MeshData& mesh);
+            void remove(const MeshHandle& mesh);
+
+            DrawCommand makeCommand(const MeshHandle& mesh, ShaderProgram* program, GLenum mode = GL_TRIANGLES) const noexcept;
+
+            // one call for all the meshes with WEBGL_multi_draw / EXT_multi_draw_arrays, a loop otherwise
+            void drawMultiple(StateCache& state, const MeshHandle* meshes, size_t count, GLenum mode = GL_TRIANGLES);
+            bool hasMultiDraw() const noexcept;
+
+            GLuint getVertexArray() const noexcept;
+            GLenum getIndexType() const noexcept;
+
+            // what the mesh takes in the buffers, indices at the arena index size
+            size_t getBytes(const MeshHandle& mesh) const noexcept;
+            const RangeAllocator& getVertexAllocator() const noexcept;
+            const RangeAllocator& getIndexAllocator() const noexcept;
+
+        private:
+
+            using MultiDrawElements = void(*)(GLenum mode, const GLsizei* counts, GLenum type, const void* const* offsets, GLsizei drawCount);
+            using MultiDrawArrays = void(*)(GLenum mode, const GLint* firsts, const GLsizei* counts, GLsizei drawCount);
+
+            VertexLayout _layout;
+            GLenum _indexType;
+            uint32_t _indexSize;
+
+            GLuint _vao;
+            GLuint _vertexBuffer;
+            GLuint _indexBuffer;
+
+            RangeAllocator _vertices;
+            RangeAllocator _indices;
+
+            MultiDrawElements _multiDrawElements;
+            MultiDrawArrays _multiDrawArrays;
+
+            // scratch memory, reused between calls
+            std::vector<uint8_t> _rebasedIndices;
+            std::vector<uint32_t> _widenedIndices;
+            std::vector<GLsizei> _counts;
+            std::vector<GLint> _firsts;
+            std::vector<const void*> _offsets;
+
+            uint32_t reserve(StateCache& state, RangeAllocator& allocator, GLuint& buffer, GLenum target, uint32_t elementSize, uint32_t count);
+            void grow(StateCache& state, RangeAllocator& allocator, GLuint& buffer, GLenum target, uint32_t elementSize, uint32_t capacity);
+            void setAttributes(StateCache& state);
+        };
+    }
+}
@@ -0,0 +1,316 @@
+#include "GpuProfiler.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+// EXT_disjoint_timer_query
+#ifndef GL_TIME_ELAPSED_EXT
+    #define GL_TIME_ELAPSED_EXT 0x88BF
+#endif
+
+#ifndef GL_GPU_DISJOINT_EXT
+    #define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
+namespace isc
+{
+    namespace gl
+    {
+        constexpr size_t GpuProfiler::MaxPasses;
+        constexpr size_t GpuProfiler::FramesInFlight;
+
+        GpuProfiler::Scope::Scope(GpuProfiler& profiler, const char* name)
+            : _profiler(&profiler)
+        {
+            _profiler->beginPass(name);
+        }
+
+        GpuProfiler::Scope::Scope(Scope&& other) noexcept
+            : _profiler(other._profiler)
+        {
+            other._profiler = nullptr;
+        }
+
+        GpuProfiler::Scope::~Scope()
+        {
+            if (_profiler != nullptr)
+            {
+                _profiler->endPass();
+            }
+        }
+
+        GpuProfiler::GpuProfiler()
+            : _initialized(false)
+            , _hasTimerQueries(false)
+            , _currentFrame(0)
+            , _passOpen(false)
+            , _resultCount(0)
+            , _totalCount(0)
+            , _totalFrames(0)
+            , _lastReport(std::chrono::steady_clock::now())
+        {
+        }
+
+        GpuProfiler::~GpuProfiler()
+        {
+            if (!_hasTimerQueries)
+            {
+                return;
+            }
+
+            for (auto& frame : _frames)
+            {
+                glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+            }
+        }
+
+        void GpuProfiler::init()
+        {
+#ifdef __EMSCRIPTEN__
+            _hasTimerQueries = hasExtension("EXT_disjoint_timer_query_webgl2");
+#else
+            _hasTimerQueries = hasExtension("GL_EXT_disjoint_timer_query");
+#endif
+
+            if (_hasTimerQueries)
+            {
+                for (auto& frame : _frames)
+                {
+                    GL(glGenQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data()));
+                }
+            }
+
+            std::cout << "[GPU Profiler] "
+                << (_hasTimerQueries ? "timer queries available" : "no timer queries, CPU submit time only")
+                << std::endl;
+
+            _initialized = true;
+        }
+
+        bool GpuProfiler::hasTimerQueries() const noexcept
+        {
+            return _hasTimerQueries;
+        }
+
+        void GpuProfiler::beginFrame()
+        {
+            if (!_initialized)
+            {
+                return;
+            }
+
+            _currentFrame = (_currentFrame + 1) % FramesInFlight;
+
+            // oldest frame still waiting: its results are lost if the GPU is that late
+            Frame& frame = _frames[_currentFrame];
+
+            if (frame.pending)
+            {
+                resolve(frame);
+            }
+
+            frame.passCount = 0;
+            frame.pending = false;
+        }
+
+        void GpuProfiler::endFrame()
+        {
+            if (!_initialized)
+            {
+                return;
+            }
+
+            Frame& current = _frames[_currentFrame];
+            current.pending = current.passCount > 0;
+
+            if (!_hasTimerQueries)
+            {
+                // nothing to wait for
+                resolve(current);
+                return;
+            }
+
+            // resolve, oldest first, every frame whose queries are ready
+            for (size_t i = 1; i < FramesInFlight; ++i)
+            {
+                Frame& frame = _frames[(_currentFrame + i) % FramesInFlight];
+
+                if (!frame.pending)
+                {
+                    continue;
+                }
+
+                GLuint available = GL_FALSE;
+                GL(glGetQueryObjectuiv(frame.queries[frame.passCount - 1], GL_QUERY_RESULT_AVAILABLE, &available));
+
+                if (available != GL_TRUE)
+                {
+                    break;
+                }
+
+                resolve(frame);
+            }
+        }
+
+        GpuProfiler::Scope GpuProfiler::scope(const char* name)
+        {
+            return Scope(*this, name);
+        }
+
+        void GpuProfiler::beginPass(const char* name)
+        {
+            Frame& frame = _frames[_currentFrame];
+
+            if (!_initialized || _passOpen || frame.passCount == MaxPasses)
+            {
+                return;
+            }
+
+            PassTiming& pass = frame.passes[frame.passCount];
+            pass.name = name;
+            pass.hasGpuTime = false;
+
+            if (_hasTimerQueries)
+            {
+                GL(glBeginQuery(GL_TIME_ELAPSED_EXT, frame.queries[frame.passCount]));
+            }
+
+            _passOpen = true;
+            _passStart = std::chrono::steady_clock::now();
+        }
+
+        void GpuProfiler::endPass()
+        {
+            if (!_passOpen)
+            {
+                return;
+            }
+
+            Frame& frame = _frames[_currentFrame];
+            frame.passes[frame.passCount].cpu = std::chrono::steady_clock::now() - _passStart;
+
+            if (_hasTimerQueries)
+            {
+                GL(glEndQuery(GL_TIME_ELAPSED_EXT));
+            }
+
+            ++frame.passCount;
+            _passOpen = false;
+        }
+
+        void GpuProfiler::resolve(Frame& frame)
+        {
+            bool disjoint = false;
+
+            if (_hasTimerQueries)
+            {
+                // results are meaningless if the GPU changed frequency, got reset...
+                GLint disjointOccurred = GL_FALSE;
+                GL(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjointOccurred));
+                disjoint = disjointOccurred != GL_FALSE;
+            }
+
+            // passes are matched by position, a frame with a different layout restarts the totals
+            bool sameLayout = frame.passCount == _totalCount;
+
+            for (size_t i = 0; sameLayout && i < frame.passCount; ++i)
+            {
+                sameLayout = std::strcmp(_totals[i].name, frame.passes[i].name) == 0;
+            }
+
+            if (!sameLayout)
+            {
+                _totalCount = frame.passCount;
+                _totalFrames = 0;
+
+                for (size_t i = 0; i < frame.passCount; ++i)
+                {
+                    _totals[i] = PassTiming();
+                    _totals[i].name = frame.passes[i].name;
+                    _totals[i].hasGpuTime = true;
+                }
+            }
+
+            for (size_t i = 0; i < frame.passCount; ++i)
+            {
+                PassTiming& pass = frame.passes[i];
+
+                if (_hasTimerQueries && !disjoint)
+                {
+                    GLuint available = GL_FALSE;
+                    GL(glGetQueryObjectuiv(frame.queries[i], GL_QUERY_RESULT_AVAILABLE, &available));
+
+                    if (available == GL_TRUE)
+                    {
+                        GLuint nanoseconds = 0;
+                        GL(glGetQueryObjectuiv(frame.queries[i], GL_QUERY_RESULT, &nanoseconds));
+
+                        pass.gpu = std::chrono::nanoseconds(nanoseconds);
+                        pass.hasGpuTime = true;
+                    }
+                }
+
+                _results[i] = pass;
+
+                _totals[i].cpu += pass.cpu;
+                _totals[i].gpu += pass.gpu;
+                _totals[i].hasGpuTime = _totals[i].hasGpuTime && pass.hasGpuTime;
+            }
+
+            _resultCount = frame.passCount;
+            ++_totalFrames;
+
+            frame.pending = false;
+        }
+
+        const PassTiming* GpuProfiler::begin() const noexcept
+        {
+            return _results.data();
+        }
+
+        const PassTiming* GpuProfiler::end() const noexcept
+        {
+            return _results.data() + _resultCount;
+        }
+
+        void GpuProfiler::report(std::ostream& output)
+        {
+            using namespace std::chrono_literals;
+
+            const auto now = std::chrono::steady_clock::now();
+
+            if (now - _lastReport < 1s || _totalFrames == 0)
+            {
+                return;
+            }
+
+            output << "[GPU Profiler]" << std::setprecision(3);
+
+            for (size_t i = 0; i < _totalCount; ++i)
+            {
+                const PassTiming& total = _totals[i];
+                output << " " << total.name << ": cpu " << (total.cpu / _totalFrames).count() << "ms";
+
+                if (total.hasGpuTime)
+                {
+                    output << " gpu " << (total.gpu / _totalFrames).count() << "ms";
+                }
+
+                output << (i + 1 < _totalCount ? "," : "");
+            }
+
+            output << std::endl;
+
+            for (size_t i = 0; i < _totalCount; ++i)
+            {
+                _totals[i].cpu = DeltaTime(0);
+                _totals[i].gpu = DeltaTime(0);
+                _totals[i].hasGpuTime = true;
+            }
+
+            _totalFrames = 0;
+            _lastReport = now;
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+#include <Engine/Common.hpp>
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        struct PassTiming
+        {
+            const char* name = nullptr;
+            DeltaTime cpu = DeltaTime(0);   // time spent submitting the pass
+            DeltaTime gpu = DeltaTime(0);   // only valid when hasGpuTime
+            bool hasGpuTime = false;
+        };
+
+        // Measures render passes on the GPU with EXT_disjoint_timer_query.
+        // Queries are read back a few frames later, never stalling the pipeline.
+        // Without the extension (llvmpipe, some browsers) only the CPU submit time is reported.
+        // Passes can't be nested: only one GL_TIME_ELAPSED query can be active.
+        class GpuProfiler
+        {
+        public:
+
+            static constexpr size_t MaxPasses = 16;
+            static constexpr size_t FramesInFlight = 4;
+
+            class Scope
+            {
+            public:
+
+                Scope(GpuProfiler& profiler, const char* name);
+                ~Scope();
+
+                Scope(Scope&& other) noexcept;
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+
+            private:
+
+                GpuProfiler* _profiler;
+            };
+
+            GpuProfiler();
+            ~GpuProfiler();
+
+            GpuProfiler(const GpuProfiler&) = delete;
+            GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+            // requires a current GL context
+            void init();
+            bool hasTimerQueries() const noexcept;
+
+            void beginFrame();
+            void endFrame();
+
+            Scope scope(const char* name);
+            void beginPass(const char* name);
+            void endPass();
+
+            // latest frame whose results arrived
+            const PassTiming* begin() const noexcept;
+            const PassTiming* end() const noexcept;
+
+            // averages since the previous report, printed once per second
+            void report(std::ostream& output);
+
+        private:
+
+            struct Frame
+            {
+                std::array<PassTiming, MaxPasses> passes;
+                std::array<GLuint, MaxPasses> queries;
+                size_t passCount = 0;
+                bool pending = false;
+            };
+
+            bool _initialized;
+            bool _hasTimerQueries;
+
+            std::array<Frame, FramesInFlight> _frames;
+            size_t _currentFrame;
+            bool _passOpen;
+            std::chrono::steady_clock::time_point _passStart;
+
+            std::array<PassTiming, MaxPasses> _results;
+            size_t _resultCount;
+
+            std::array<PassTiming, MaxPasses> _totals;
+            size_t _totalCount;
+            size_t _totalFrames;
+            std::chrono::steady_clock::time_point _lastReport;
+
+            void resolve(Frame& frame);
+        };
+    }
+}
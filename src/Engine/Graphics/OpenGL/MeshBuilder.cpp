@@ -0,0 +1,195 @@
+#include "MeshBuilder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <Engine/Exceptions/RuntimeException.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        constexpr GLuint MeshBuilder::PositionLocation;
+        constexpr GLuint MeshBuilder::UVLocation;
+        constexpr GLuint MeshBuilder::ColorLocation;
+
+        namespace
+        {
+            int16_t toSnorm16(float value) noexcept
+            {
+                return static_cast<int16_t>(std::lround(glm::clamp(value, -1.f, 1.f) * 32767.f));
+            }
+
+            uint16_t toUnorm16(float value) noexcept
+            {
+                return static_cast<uint16_t>(std::lround(glm::clamp(value, 0.f, 1.f) * 65535.f));
+            }
+
+            uint8_t toUnorm8(float value) noexcept
+            {
+                return static_cast<uint8_t>(std::lround(glm::clamp(value, 0.f, 1.f) * 255.f));
+            }
+
+            template<typename TValue>
+            void write(std::vector<uint8_t>& output, size_t offset, const TValue& value)
+            {
+                std::memcpy(output.data() + offset, &value, sizeof(TValue));
+            }
+        }
+
+        glm::mat4 MeshData::getDequantization() const noexcept
+        {
+            return glm::scale(glm::mat4(1.f), glm::vec3(positionScale));
+        }
+
+        size_t MeshData::getSavedBytes() const noexcept
+        {
+            return floatBytes > bytes ? floatBytes - bytes : 0;
+        }
+
+        MeshBuilder::MeshBuilder(bool hasUV, bool hasColor)
+            : _hasUV(hasUV)
+            , _hasColor(hasColor)
+        {
+        }
+
+        uint32_t MeshBuilder::addVertex(const glm::vec3& position, const glm::vec2& uv, const glm::vec4& color)
+        {
+            _vertices.push_back({ position, uv, color });
+            return static_cast<uint32_t>(_vertices.size() - 1);
+        }
+
+        void MeshBuilder::addTriangle(uint32_t a, uint32_t b, uint32_t c)
+        {
+            _indices.insert(_indices.end(), { a, b, c });
+        }
+
+        void MeshBuilder::addIndex(uint32_t index)
+        {
+            _indices.push_back(index);
+        }
+
+        GLenum MeshBuilder::getIndexType(size_t vertexCount) noexcept
+        {
+            if (vertexCount <= 256)
+            {
+                return GL_UNSIGNED_BYTE;
+            }
+
+            return vertexCount <= 65536
+                ? GL_UNSIGNED_SHORT
+                : GL_UNSIGNED_INT;
+        }
+
+        VertexLayout MeshBuilder::getLayout() const
+        {
+            VertexLayout layout;
+            layout.stride = 4 * sizeof(int16_t);
+            layout.attributes.push_back({ PositionLocation, 4, GL_SHORT, GL_TRUE, 0 });
+
+            if (_hasUV)
+            {
+                layout.attributes.push_back({ UVLocation, 2, GL_UNSIGNED_SHORT, GL_TRUE, layout.stride });
+                layout.stride += 2 * sizeof(uint16_t);
+            }
+
+            if (_hasColor)
+            {
+                layout.attributes.push_back({ ColorLocation, 4, GL_UNSIGNED_BYTE, GL_TRUE, layout.stride });
+                layout.stride += 4 * sizeof(uint8_t);
+            }
+
+            return layout;
+        }
+
+        MeshData MeshBuilder::build() const
+        {
+            MeshData mesh;
+            mesh.layout = getLayout();
+            mesh.vertexCount = static_cast<uint32_t>(_vertices.size());
+            mesh.indexCount = static_cast<uint32_t>(_indices.size());
+
+            // normalized shorts cover [-1, 1]: larger meshes are scaled down uniformly
+            for (const Vertex& vertex : _vertices)
+            {
+                const glm::vec3 extent = glm::abs(vertex.position);
+                mesh.positionScale = std::max({ mesh.positionScale, extent.x, extent.y, extent.z });
+            }
+
+            mesh.vertices.resize(static_cast<size_t>(mesh.vertexCount) * mesh.layout.stride);
+
+            for (size_t i = 0; i < _vertices.size(); ++i)
+            {
+                const Vertex& vertex = _vertices[i];
+                const glm::vec3 position = vertex.position / mesh.positionScale;
+
+                size_t offset = i * mesh.layout.stride;
+
+                // w is padding, it reads as 1 so vec4 inputs work too
+                write(mesh.vertices, offset, toSnorm16(position.x));
+                write(mesh.vertices, offset + 2, toSnorm16(position.y));
+                write(mesh.vertices, offset + 4, toSnorm16(position.z));
+                write(mesh.vertices, offset + 6, toSnorm16(1.f));
+                offset += 8;
+
+                if (_hasUV)
+                {
+                    write(mesh.vertices, offset, toUnorm16(vertex.uv.x));
+                    write(mesh.vertices, offset + 2, toUnorm16(vertex.uv.y));
+                    offset += 4;
+                }
+
+                if (_hasColor)
+                {
+                    for (int channel = 0; channel < 4; ++channel)
+                    {
+                        write(mesh.vertices, offset + static_cast<size_t>(channel), toUnorm8(vertex.color[channel]));
+                    }
+                }
+            }
+
+            if (!_indices.empty())
+            {
+                // narrowed below: an index out of range would silently point to another vertex
+                for (const uint32_t index : _indices)
+                {
+                    if (index >= mesh.vertexCount)
+                    {
+                        throw RuntimeException("Mesh index out of range",
+                            std::to_string(index) + " >= " + std::to_string(mesh.vertexCount) + " vertices");
+                    }
+                }
+
+                mesh.indexType = getIndexType(_vertices.size());
+
+                const size_t indexSize = mesh.indexType == GL_UNSIGNED_BYTE ? 1
+                    : mesh.indexType == GL_UNSIGNED_SHORT ? 2
+                    : 4;
+
+                mesh.indices.resize(_indices.size() * indexSize);
+
+                for (size_t i = 0; i < _indices.size(); ++i)
+                {
+                    switch (indexSize)
+                    {
+                        case 1: write(mesh.indices, i, static_cast<uint8_t>(_indices[i])); break;
+                        case 2: write(mesh.indices, i * 2, static_cast<uint16_t>(_indices[i])); break;
+                        default: write(mesh.indices, i * 4, _indices[i]); break;
+                    }
+                }
+            }
+
+            const size_t floatStride = 3 * sizeof(float)
+                + (_hasUV ? 2 * sizeof(float) : 0)
+                + (_hasColor ? 4 * sizeof(float) : 0);
+
+            mesh.floatBytes = mesh.vertexCount * floatStride + mesh.indexCount * sizeof(uint32_t);
+            mesh.bytes = mesh.vertices.size() + mesh.indices.size();
+
+            return mesh;
+        }
+    }
+}
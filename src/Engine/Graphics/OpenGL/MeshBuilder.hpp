@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Graphics/OpenGL/GeometryArena.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        struct MeshData
+        {
+            VertexLayout layout;
+            std::vector<uint8_t> vertices;
+            std::vector<uint8_t> indices;
+            GLenum indexType = GL_NONE;
+            uint32_t vertexCount = 0;
+            uint32_t indexCount = 0;
+
+            // positions are stored divided by this, scale the model matrix by getDequantization()
+            float positionScale = 1.f;
+
+            size_t floatBytes = 0;  // same mesh with float attributes and 32 bit indices
+            size_t bytes = 0;       // with its own index type, a GeometryArena stores them with its own (getBytes())
+
+            glm::mat4 getDequantization() const noexcept;
+            size_t getSavedBytes() const noexcept;
+        };
+
+        // Builds meshes with the smallest formats that keep them accurate enough:
+        // - indices: 8, 16 or 32 bits depending on the vertex count
+        // - position: normalized shorts, 4 of them to keep every attribute 4 byte aligned (location 0)
+        // - uv: normalized unsigned shorts (location 1)
+        // - color: normalized unsigned bytes (location 2)
+        class MeshBuilder
+        {
+        public:
+
+            static constexpr GLuint PositionLocation = 0;
+            static constexpr GLuint UVLocation = 1;
+            static constexpr GLuint ColorLocation = 2;
+
+            explicit MeshBuilder(bool hasUV = false, bool hasColor = false);
+
+            uint32_t addVertex(const glm::vec3& position, const glm::vec2& uv = glm::vec2(0.f), const glm::vec4& color = glm::vec4(1.f));
+            void addTriangle(uint32_t a, uint32_t b, uint32_t c);
+            void addIndex(uint32_t index);
+
+            // throws if an index doesn't refer to a vertex
+            MeshData build() const;
+            VertexLayout getLayout() const;
+
+            static GLenum getIndexType(size_t vertexCount) noexcept;
+
+        private:
+
+            struct Vertex
+            {
+                glm::vec3 position;
+                glm::vec2 uv;
+                glm::vec4 color;
+            };
+
+            bool _hasUV;
+            bool _hasColor;
+
+            std::vector<Vertex> _vertices;
+            std::vector<uint32_t> _indices;
+        };
+    }
+}
@@ -1,5 +1,6 @@
 #include "OpenGL.hpp"
 
+#include <cstring>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -47,10 +48,17 @@ namespace isc
             return true;
         }
 
-        void link()
+        namespace
         {
+            ProcAddressLoader linkedLoader = nullptr;
+        }
+
+        void link(ProcAddressLoader loader)
+        {
+            linkedLoader = loader;
+
 #ifndef __EMSCRIPTEN__
-            if (!gladLoadGLES2Loader(SDL_GL_GetProcAddress))
+            if (!gladLoadGLES2Loader(loader))
             {
                 std::cout << "Error initializing OpenGL ES 3.0" << std::endl;
                 std::abort();
@@ -64,6 +72,15 @@ namespace isc
 #endif
         }
 
+        void* getProcAddress(const char* name)
+        {
+#ifdef __EMSCRIPTEN__
+            return nullptr;
+#else
+            return linkedLoader != nullptr ? linkedLoader(name) : nullptr;
+#endif
+        }
+
         void printContext()
         {
             std::cout << "[OpenGL] " << glGetString(GL_VERSION) << std::endl;
@@ -78,6 +95,44 @@ namespace isc
 #endif
         }
 
+        std::string getDriverString()
+        {
+            std::string result;
+
+            for (GLenum name : { GL_VERSION, GL_VENDOR, GL_RENDERER, GL_SHADING_LANGUAGE_VERSION })
+            {
+                const auto* value = reinterpret_cast<const char*>(glGetString(name));
+                result += value != nullptr ? value : "";
+                result += '\n';
+            }
+
+            return result;
+        }
+
+        bool hasExtension(const char* name)
+        {
+#ifdef __EMSCRIPTEN__
+            return emscripten_webgl_enable_extension(
+                emscripten_webgl_get_current_context(),
+                name) == EM_TRUE;
+#else
+            GLint count = 0;
+            GL(glGetIntegerv(GL_NUM_EXTENSIONS, &count));
+
+            for (GLint i = 0; i < count; ++i)
+            {
+                const auto* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+
+                if (extension != nullptr && std::strcmp(extension, name) == 0)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+#endif
+        }
+
         GLuint compileProgram(const char* vertexSource, const char* fragmentSource)
         {
             // Create and compile the vertex shader
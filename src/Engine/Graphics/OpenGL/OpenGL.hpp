@@ -59,8 +59,20 @@ namespace isc
 
         bool checkError(const char* file, const int line, const char* call);
 
-        void link();
+        using ProcAddressLoader = void*(*)(const char* name);
+
+        void link(ProcAddressLoader loader = SDL_GL_GetProcAddress);
+
+        // extension entry points glad doesn't load, nullptr if missing (native only)
+        void* getProcAddress(const char* name);
         void printContext();
+
+        // version, vendor, renderer and GLSL version: changes whenever the driver does
+        std::string getDriverString();
+
+        // WebGL: also enables the extension, names don't have the GL_ prefix
+        bool hasExtension(const char* name);
+
         GLuint compileProgram(const char* vertexSource, const char* fragmentSource);
     }
 }
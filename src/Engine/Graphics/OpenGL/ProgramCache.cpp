@@ -0,0 +1,404 @@
+#include "ProgramCache.hpp"
+
+#include <cstdio>
+#include <vector>
+
+#include <Engine/Debug/ProfileZone.hpp>
+#include <Engine/Exceptions/RuntimeException.hpp>
+#include <Engine/SDL/Object.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        namespace
+        {
+            constexpr GLenum CompletionStatus = 0x91B1; // GL_COMPLETION_STATUS_KHR
+            constexpr uint32_t BinaryMagic = 0x50435349; // "ISCP"
+            constexpr uint32_t BinaryVersion = 1;
+
+            // FNV-1a, 64 bits
+            uint64_t hash(const std::string& text, uint64_t result = 14695981039346656037ull) noexcept
+            {
+                for (char character : text)
+                {
+                    result ^= static_cast<uint8_t>(character);
+                    result *= 1099511628211ull;
+                }
+
+                // separator, so ("ab", "c") and ("a", "bc") differ
+                result ^= 0xFF;
+                result *= 1099511628211ull;
+
+                return result;
+            }
+
+            std::string addDefines(const char* source, const std::string& defines)
+            {
+                std::string result = source;
+
+                if (defines.empty())
+                {
+                    return result;
+                }
+
+                // #version has to stay the first line
+                size_t position = 0;
+
+                if (result.compare(0, 8, "#version") == 0)
+                {
+                    position = result.find('\n');
+                    position = position == std::string::npos ? result.size() : position + 1;
+                }
+
+                result.insert(position, defines + "\n");
+
+                return result;
+            }
+
+            GLuint startCompile(GLenum type, const std::string& source)
+            {
+                const GLchar* text = source.c_str();
+
+                GLuint shader = GL(glCreateShader(type));
+                GL(glShaderSource(shader, 1, &text, nullptr));
+                GL(glCompileShader(shader));
+
+                return shader;
+            }
+
+            std::string getShaderLog(GLuint shader)
+            {
+                GLint length = 0;
+                GL(glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length));
+
+                if (length <= 1)
+                {
+                    return "";
+                }
+
+                std::vector<char> log(static_cast<size_t>(length) + 1);
+                GL(glGetShaderInfoLog(shader, length, nullptr, log.data()));
+
+                return log.data();
+            }
+
+            std::string getProgramLog(GLuint program)
+            {
+                GLint length = 0;
+                GL(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
+
+                if (length <= 1)
+                {
+                    return "";
+                }
+
+                std::vector<char> log(static_cast<size_t>(length) + 1);
+                GL(glGetProgramInfoLog(program, length, nullptr, log.data()));
+
+                return log.data();
+            }
+        }
+
+        ProgramCache::ProgramCache()
+            : _parallelCompile(false)
+            , _binaries(false)
+            , _pendingCount(0)
+            , _loadedCount(0)
+            , _compiledCount(0)
+        {
+        }
+
+        ProgramCache::~ProgramCache()
+        {
+            for (Entry& entry : _entries)
+            {
+                if (entry.pending != 0)
+                {
+                    glDeleteShader(entry.vertexShader);
+                    glDeleteShader(entry.fragmentShader);
+                    glDeleteProgram(entry.pending);
+                }
+            }
+        }
+
+        void ProgramCache::init(const std::string& directory)
+        {
+            _driver = getDriverString();
+
+#ifdef __EMSCRIPTEN__
+            _parallelCompile = hasExtension("KHR_parallel_shader_compile");
+            _binaries = false; // WebGL has no program binaries
+#else
+            _parallelCompile = hasExtension("GL_KHR_parallel_shader_compile");
+
+            if (_parallelCompile)
+            {
+                // as many threads as the driver wants
+                using MaxShaderCompilerThreads = void(*)(GLuint count);
+                auto maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreads>(getProcAddress("glMaxShaderCompilerThreadsKHR"));
+
+                if (maxShaderCompilerThreads != nullptr)
+                {
+                    maxShaderCompilerThreads(0xFFFFFFFF);
+                }
+            }
+
+            GLint formats = 0;
+            GL(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+
+            _directory = directory;
+
+            if (_directory.empty())
+            {
+                char* path = SDL_GetPrefPath("isc", "shaders");
+
+                if (path != nullptr)
+                {
+                    _directory = path;
+                    SDL_free(path);
+                }
+            }
+
+            _binaries = formats > 0 && !_directory.empty();
+#endif
+
+            std::cout << "[ProgramCache] parallel compile: " << (_parallelCompile ? "yes" : "no")
+                << ", binaries: " << (_binaries ? _directory : "no") << std::endl;
+        }
+
+        ProgramCache::Handle ProgramCache::request(const char* vertexSource, const char* fragmentSource, const std::string& defines)
+        {
+            const uint64_t key = hash(_driver, hash(defines, hash(fragmentSource, hash(vertexSource))));
+            const auto existing = _lookup.find(key);
+
+            if (existing != _lookup.end())
+            {
+                return existing->second;
+            }
+
+            const auto handle = static_cast<Handle>(_entries.size());
+
+            _entries.emplace_back();
+            _entries.back().key = key;
+            _lookup.emplace(key, handle);
+
+            if (!load(_entries.back()))
+            {
+                compile(_entries.back(), addDefines(vertexSource, defines), addDefines(fragmentSource, defines));
+            }
+
+            return handle;
+        }
+
+        bool ProgramCache::isReady(Handle program) const
+        {
+            const Entry& entry = _entries.at(program);
+
+            if (entry.pending == 0)
+            {
+                return true;
+            }
+
+            // without the extension any status query waits for the compiler, get() is going to wait anyway
+            if (!_parallelCompile)
+            {
+                return true;
+            }
+
+            GLint done = GL_FALSE;
+            GL(glGetProgramiv(entry.pending, CompletionStatus, &done));
+
+            return done == GL_TRUE;
+        }
+
+        ShaderProgram& ProgramCache::get(Handle program)
+        {
+            Entry& entry = _entries.at(program);
+
+            if (entry.pending != 0)
+            {
+                finish(entry);
+            }
+
+            return entry.program;
+        }
+
+        bool ProgramCache::hasParallelCompile() const noexcept
+        {
+            return _parallelCompile;
+        }
+
+        bool ProgramCache::hasBinaries() const noexcept
+        {
+            return _binaries;
+        }
+
+        size_t ProgramCache::getPendingCount() const noexcept
+        {
+            return _pendingCount;
+        }
+
+        size_t ProgramCache::getLoadedCount() const noexcept
+        {
+            return _loadedCount;
+        }
+
+        size_t ProgramCache::getCompiledCount() const noexcept
+        {
+            return _compiledCount;
+        }
+
+        std::string ProgramCache::getPath(uint64_t key) const
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+
+            return _directory + name;
+        }
+
+        bool ProgramCache::load(Entry& entry)
+        {
+#ifdef __EMSCRIPTEN__
+            return false;
+#else
+            if (!_binaries)
+            {
+                return false;
+            }
+
+            SDL_RWops* source = SDL_RWFromFile(getPath(entry.key).c_str(), "rb");
+
+            if (source == nullptr)
+            {
+                return false;
+            }
+
+            auto file = sdl::makeObject<SDL_RWops>(source, [](SDL_RWops* file) { SDL_RWclose(file); });
+
+            if (SDL_ReadLE32(file.get()) != BinaryMagic || SDL_ReadLE32(file.get()) != BinaryVersion)
+            {
+                return false;
+            }
+
+            const auto format = static_cast<GLenum>(SDL_ReadLE32(file.get()));
+            const uint32_t length = SDL_ReadLE32(file.get());
+
+            std::vector<uint8_t> binary(length);
+
+            if (length == 0 || SDL_RWread(file.get(), binary.data(), 1, length) != length)
+            {
+                return false;
+            }
+
+            GLuint program = GL(glCreateProgram());
+            GL(glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(length)));
+
+            // drivers can reject binaries they wrote themselves, compiling from source still works
+            GLint linked = GL_FALSE;
+            GL(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+
+            if (linked != GL_TRUE)
+            {
+                GL(glDeleteProgram(program));
+                return false;
+            }
+
+            entry.program.create(program);
+            ++_loadedCount;
+
+            return true;
+#endif
+        }
+
+        void ProgramCache::save(const Entry& entry)
+        {
+#ifndef __EMSCRIPTEN__
+            GLint length = 0;
+            GL(glGetProgramiv(entry.pending, GL_PROGRAM_BINARY_LENGTH, &length));
+
+            if (length <= 0)
+            {
+                return;
+            }
+
+            std::vector<uint8_t> binary(static_cast<size_t>(length));
+            GLenum format = GL_NONE;
+            GL(glGetProgramBinary(entry.pending, length, &length, &format, binary.data()));
+
+            SDL_RWops* destination = SDL_RWFromFile(getPath(entry.key).c_str(), "wb");
+
+            // a read only cache directory only costs the next launch a compile
+            if (destination == nullptr)
+            {
+                return;
+            }
+
+            auto file = sdl::makeObject<SDL_RWops>(destination, [](SDL_RWops* file) { SDL_RWclose(file); });
+
+            SDL_WriteLE32(file.get(), BinaryMagic);
+            SDL_WriteLE32(file.get(), BinaryVersion);
+            SDL_WriteLE32(file.get(), format);
+            SDL_WriteLE32(file.get(), static_cast<uint32_t>(length));
+            SDL_RWwrite(file.get(), binary.data(), 1, static_cast<size_t>(length));
+#endif
+        }
+
+        void ProgramCache::compile(Entry& entry, const std::string& vertexSource, const std::string& fragmentSource)
+        {
+            // no status queries here: they would wait for the compiler
+            entry.vertexShader = startCompile(GL_VERTEX_SHADER, vertexSource);
+            entry.fragmentShader = startCompile(GL_FRAGMENT_SHADER, fragmentSource);
+
+            entry.pending = GL(glCreateProgram());
+            GL(glAttachShader(entry.pending, entry.vertexShader));
+            GL(glAttachShader(entry.pending, entry.fragmentShader));
+
+#ifndef __EMSCRIPTEN__
+            if (_binaries)
+            {
+                GL(glProgramParameteri(entry.pending, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+            }
+#endif
+
+            GL(glLinkProgram(entry.pending));
+
+            ++_pendingCount;
+        }
+
+        void ProgramCache::finish(Entry& entry)
+        {
+            ISC_PROFILE_SCOPE("link program");
+
+            GLint linked = GL_FALSE;
+            GL(glGetProgramiv(entry.pending, GL_LINK_STATUS, &linked));
+
+            if (linked != GL_TRUE)
+            {
+                const std::string log = "vertex: " + getShaderLog(entry.vertexShader)
+                    + "\nfragment: " + getShaderLog(entry.fragmentShader)
+                    + "\nprogram: " + getProgramLog(entry.pending);
+
+                throw RuntimeException("Error linking shader program", log);
+            }
+
+            if (_binaries)
+            {
+                save(entry);
+            }
+
+            GL(glDetachShader(entry.pending, entry.vertexShader));
+            GL(glDetachShader(entry.pending, entry.fragmentShader));
+            GL(glDeleteShader(entry.vertexShader));
+            GL(glDeleteShader(entry.fragmentShader));
+
+            entry.program.create(entry.pending);
+            entry.pending = 0;
+            entry.vertexShader = 0;
+            entry.fragmentShader = 0;
+
+            --_pendingCount;
+            ++_compiledCount;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Graphics/OpenGL/ShaderProgram.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        // Programs are requested up front and only waited for when first used:
+        // - request() issues the compile and link without reading any status back
+        // - with KHR_parallel_shader_compile the driver compiles them on its own threads, isReady() never blocks
+        // - get() blocks until the program is linked, then reflects it
+        //
+        // Natively, linked programs are saved with glGetProgramBinary and loaded on the next launch.
+        // The key hashes the sources, the defines and the driver string, a driver update means a recompile.
+        class ProgramCache
+        {
+        public:
+
+            using Handle = uint32_t;
+
+            ProgramCache();
+            ~ProgramCache();
+
+            ProgramCache(const ProgramCache&) = delete;
+            ProgramCache& operator=(const ProgramCache&) = delete;
+
+            // requires a current GL context, empty directory: SDL preference path
+            void init(const std::string& directory = "");
+
+            // defines go right after the #version line of both stages, same request: same handle
+            Handle request(const char* vertexSource, const char* fragmentSource, const std::string& defines = "");
+
+            bool isReady(Handle program) const;
+            ShaderProgram& get(Handle program);
+
+            bool hasParallelCompile() const noexcept;
+            bool hasBinaries() const noexcept;
+
+            size_t getPendingCount() const noexcept;
+            size_t getLoadedCount() const noexcept;
+            size_t getCompiledCount() const noexcept;
+
+        private:
+
+            struct Entry
+            {
+                uint64_t key = 0;
+                ShaderProgram program;
+
+                // until linked
+                GLuint pending = 0;
+                GLuint vertexShader = 0;
+                GLuint fragmentShader = 0;
+            };
+
+            std::string _directory;
+            std::string _driver;
+            bool _parallelCompile;
+            bool _binaries;
+
+            std::deque<Entry> _entries;
+            std::unordered_map<uint64_t, Handle> _lookup;
+
+            size_t _pendingCount;
+            size_t _loadedCount;
+            size_t _compiledCount;
+
+            std::string getPath(uint64_t key) const;
+            bool load(Entry& entry);
+            void save(const Entry& entry);
+            void compile(Entry& entry, const std::string& vertexSource, const std::string& fragmentSource);
+            void finish(Entry& entry);
+        };
+    }
+}
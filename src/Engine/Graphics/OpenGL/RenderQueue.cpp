@@ -0,0 +1,253 @@
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+
+namespace isc
+{
+    namespace gl
+    {
+        constexpr size_t RenderQueue::LayerCount;
+        constexpr uint32_t RenderQueue::NoTransform;
+
+        namespace
+        {
+            constexpr uint64_t mask(uint32_t bits) noexcept
+            {
+                return (uint64_t(1) << bits) - 1;
+            }
+
+            uint64_t quantizeDepth(float depth) noexcept
+            {
+                const float clamped = std::min(std::max(depth, 0.f), 1.f);
+                return static_cast<uint64_t>(clamped * static_cast<float>(mask(24)));
+            }
+        }
+
+        RenderQueue::RenderQueue()
+            : _drawCallCount(0)
+        {
+            _layerClear.fill(0);
+        }
+
+        void RenderQueue::setLayerClear(uint8_t layer, GLbitfield mask) noexcept
+        {
+            _layerClear[layer % LayerCount] = mask;
+        }
+
+        uint64_t RenderQueue::makeKey(const DrawCommand& command, uint8_t layer, bool translucent, float depth) noexcept
+        {
+            const uint64_t program = (command.program != nullptr ? command.program->getId() : 0) & mask(10);
+            const uint64_t texture = command.texture & mask(12);
+            const uint64_t vao = command.vao & mask(12);
+
+            uint64_t key = (uint64_t(layer) & mask(4)) << 60;
+
+            if (!translucent)
+            {
+                // state first, front to back inside the same state
+                key |= program << 49;
+                key |= texture << 37;
+                key |= vao << 25;
+                key |= quantizeDepth(depth) << 1;
+            }
+            else
+            {
+                // back to front is required for blending, state only breaks ties
+                key |= uint64_t(1) << 59;
+                key |= (mask(24) - quantizeDepth(depth)) << 35;
+                key |= program << 25;
+                key |= texture << 13;
+                key |= vao << 1;
+            }
+
+            return key;
+        }
+
+        void RenderQueue::submit(const DrawCommand& command, uint8_t layer, bool translucent, float depth)
+        {
+            _entries.push_back({ makeKey(command, layer, translucent, depth), static_cast<uint32_t>(_commands.size()) });
+            _commands.push_back({ command, NoTransform, translucent });
+        }
+
+        void RenderQueue::submit(const DrawCommand& command, const glm::mat4& transform, uint8_t layer, bool translucent, float depth)
+        {
+            _entries.push_back({ makeKey(command, layer, translucent, depth), static_cast<uint32_t>(_commands.size()) });
+            _commands.push_back({ command, static_cast<uint32_t>(_transforms.size()), translucent });
+            _transforms.push_back(transform);
+        }
+
+        void RenderQueue::sort()
+        {
+            // LSD radix sort, one byte per pass, stable so equal keys keep the submission order
+            _sortBuffer.resize(_entries.size());
+
+            for (uint32_t shift = 0; shift < 64; shift += 8)
+            {
+                std::array<size_t, 256> offsets = {};
+
+                for (const Entry& entry : _entries)
+                {
+                    ++offsets[(entry.key >> shift) & 0xFF];
+                }
+
+                // every key has the same byte: nothing to do
+                if (std::find(offsets.begin(), offsets.end(), _entries.size()) != offsets.end())
+                {
+                    continue;
+                }
+
+                size_t total = 0;
+
+                for (size_t& offset : offsets)
+                {
+                    const size_t count = offset;
+                    offset = total;
+                    total += count;
+                }
+
+                for (const Entry& entry : _entries)
+                {
+                    _sortBuffer[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+                }
+
+                _entries.swap(_sortBuffer);
+            }
+        }
+
+        bool RenderQueue::canMerge(const Command& previous, const Command& next) noexcept
+        {
+            const DrawCommand& a = previous.draw;
+            const DrawCommand& b = next.draw;
+
+            // strips and loops can't be concatenated
+            const bool isList = a.mode == GL_TRIANGLES || a.mode == GL_LINES || a.mode == GL_POINTS;
+
+            return isList
+                && previous.transform == NoTransform && next.transform == NoTransform
+                && a.uniformBuffer == b.uniformBuffer && a.uniformOffset == b.uniformOffset
+                && a.uniformSize == b.uniformSize
+                && previous.translucent == next.translucent
+                && a.program == b.program && a.vao == b.vao && a.texture == b.texture
+                && a.mode == b.mode && a.indexType == b.indexType;
+        }
+
+        void RenderQueue::draw(const DrawCommand& command, GLint first, GLsizei count) const
+        {
+            if (command.indexType == GL_NONE)
+            {
+                GL(glDrawArrays(command.mode, first, count));
+                return;
+            }
+
+            const size_t indexSize = command.indexType == GL_UNSIGNED_BYTE ? 1
+                : command.indexType == GL_UNSIGNED_SHORT ? 2
+                : 4;
+
+            GL(glDrawElements(command.mode, count, command.indexType,
+                reinterpret_cast<const void*>(static_cast<size_t>(first) * indexSize)));
+        }
+
+        void RenderQueue::execute(StateCache& state)
+        {
+            sort();
+
+            _drawCallCount = 0;
+
+            size_t layer = LayerCount;
+            const Command* batch = nullptr;
+            DrawCommand merged;
+
+            auto flush = [&]()
+            {
+                if (batch != nullptr)
+                {
+                    draw(batch->draw, merged.first, merged.count);
+                    ++_drawCallCount;
+                    batch = nullptr;
+                }
+            };
+
+            for (const Entry& entry : _entries)
+            {
+                const size_t entryLayer = static_cast<size_t>(entry.key >> 60);
+
+                if (entryLayer != layer)
+                {
+                    flush();
+                    layer = entryLayer;
+
+                    if (_layerClear[layer] != 0)
+                    {
+                        // a disabled depth mask would skip the depth clear
+                        state.setDepthMask(true);
+                        GL(glClear(_layerClear[layer]));
+                    }
+                }
+
+                const Command& command = _commands[entry.command];
+
+                // same state and the range continues where the batch ends
+                if (batch != nullptr && canMerge(*batch, command) && merged.first + merged.count == command.draw.first)
+                {
+                    merged.count += command.draw.count;
+                    continue;
+                }
+
+                flush();
+
+                state.setDepthTest(true);
+                state.setCullFace(true);
+                state.setBlend(command.translucent);
+                state.setDepthMask(!command.translucent);
+
+                if (command.draw.program != nullptr)
+                {
+                    state.useProgram(command.draw.program->getId());
+
+                    if (command.transform != NoTransform)
+                    {
+                        command.draw.program->set(command.draw.transformUniform, _transforms[command.transform]);
+                    }
+                }
+
+                if (command.draw.texture != 0)
+                {
+                    state.bindTexture(0, GL_TEXTURE_2D, command.draw.texture);
+                }
+
+                if (command.draw.uniformBuffer != 0)
+                {
+                    state.bindUniformBuffer(ObjectBinding, command.draw.uniformBuffer, command.draw.uniformOffset, command.draw.uniformSize);
+                }
+
+                state.bindVertexArray(command.draw.vao);
+
+                batch = &command;
+                merged = command.draw;
+            }
+
+            flush();
+            clear();
+
+            // leave the depth buffer clearable for the next frame
+            state.setDepthMask(true);
+        }
+
+        void RenderQueue::clear() noexcept
+        {
+            _entries.clear();
+            _commands.clear();
+            _transforms.clear();
+        }
+
+        size_t RenderQueue::getCommandCount() const noexcept
+        {
+            return _commands.size();
+        }
+
+        size_t RenderQueue::getDrawCallCount() const noexcept
+        {
+            return _drawCallCount;
+        }
+    }
+}
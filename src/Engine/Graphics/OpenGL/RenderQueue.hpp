@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Graphics/OpenGL/ShaderProgram.hpp>
+#include <Engine/Graphics/OpenGL/StateCache.hpp>
+#include <Engine/Graphics/OpenGL/UniformBuffer.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        struct DrawCommand
+        {
+            ShaderProgram* program = nullptr;
+            GLuint vao = 0;
+            GLuint texture = 0;         // unit 0, none if 0
+
+            GLenum mode = GL_TRIANGLES;
+            GLenum indexType = GL_NONE; // GL_NONE: glDrawArrays
+            GLint first = 0;            // vertex, or index for indexed draws
+            GLsizei count = 0;
+
+            ShaderProgram::Handle transformUniform = ShaderProgram::InvalidHandle;
+
+            // per object block bound to ObjectBinding, see UniformRing
+            GLuint uniformBuffer = 0;
+            GLintptr uniformOffset = 0;
+            GLsizeiptr uniformSize = 0;
+        };
+
+        // Commands are submitted in any order, sorted by a packed 64-bit key and executed with minimal state changes.
+        //
+        // opaque:      layer:4 | 0 | program:10 | texture:12 | vao:12 | depth:24 (front to back)
+        // translucent: layer:4 | 1 | depth:24 (back to front) | program:10 | texture:12 | vao:12
+        //
+        // GL names are truncated to fit: a collision only makes the grouping worse, never the output wrong.
+        class RenderQueue
+        {
+        public:
+
+            static constexpr size_t LayerCount = 16;
+
+            RenderQueue();
+
+            // the layer starts with a glClear, for example the depth buffer before a 2D layer
+            void setLayerClear(uint8_t layer, GLbitfield mask) noexcept;
+
+            // depth: 0 (near) to 1 (far)
+            void submit(const DrawCommand& command, uint8_t layer = 0, bool translucent = false, float depth = 0.f);
+            void submit(const DrawCommand& command, const glm::mat4& transform, uint8_t layer = 0, bool translucent = false, float depth = 0.f);
+
+            void execute(StateCache& state);
+            void clear() noexcept;
+
+            size_t getCommandCount() const noexcept;
+
+            // after execute(): adjacent compatible commands are merged into one draw
+            size_t getDrawCallCount() const noexcept;
+
+            static uint64_t makeKey(const DrawCommand& command, uint8_t layer, bool translucent, float depth) noexcept;
+
+        private:
+
+            static constexpr uint32_t NoTransform = ~0u;
+
+            struct Entry
+            {
+                uint64_t key;
+                uint32_t command;
+            };
+
+            struct Command
+            {
+                DrawCommand draw;
+                uint32_t transform;
+                bool translucent;
+            };
+
+            std::vector<Entry> _entries;
+            std::vector<Entry> _sortBuffer;
+            std::vector<Command> _commands;
+            std::vector<glm::mat4> _transforms;
+
+            std::array<GLbitfield, LayerCount> _layerClear;
+            size_t _drawCallCount;
+
+            void sort();
+            static bool canMerge(const Command& previous, const Command& next) noexcept;
+            void draw(const DrawCommand& command, GLint first, GLsizei count) const;
+        };
+    }
+}
@@ -0,0 +1,218 @@
+#include "ShaderLibrary.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+#include <Engine/Exceptions/RuntimeException.hpp>
+#include <Engine/SDL/Object.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        constexpr size_t ShaderLibrary::MaxFeatures;
+
+        namespace
+        {
+            // `#include "name"` -> name, empty for any other line
+            std::string getIncludeName(const std::string& line)
+            {
+                const auto start = line.find_first_not_of(" \t");
+
+                if (start == std::string::npos || line.compare(start, 8, "#include") != 0)
+                {
+                    return "";
+                }
+
+                const auto open = line.find('"', start + 8);
+                const auto close = open == std::string::npos ? open : line.find('"', open + 1);
+
+                if (close == std::string::npos)
+                {
+                    throw RuntimeException("Malformed shader #include", line);
+                }
+
+                return line.substr(open + 1, close - open - 1);
+            }
+        }
+
+        ShaderLibrary::ShaderLibrary(ProgramCache& programs)
+            : _programs(programs)
+        {
+        }
+
+        void ShaderLibrary::addSource(const std::string& name, const std::string& text)
+        {
+            _sources[name] = text;
+        }
+
+        void ShaderLibrary::loadSource(const std::string& name, const std::string& path)
+        {
+            auto file = sdl::makeObject<SDL_RWops>(SDL_RWFromFile(path.c_str(), "rb"), [](SDL_RWops* file) { SDL_RWclose(file); });
+
+            const Sint64 size = SDL_RWsize(file.get());
+
+            if (size < 0)
+            {
+                throw RuntimeException("Error reading shader source", path);
+            }
+
+            std::string text(static_cast<size_t>(size), '\0');
+
+            if (size > 0 && SDL_RWread(file.get(), &text[0], 1, text.size()) != text.size())
+            {
+                throw RuntimeException("Error reading shader source", path);
+            }
+
+            addSource(name, text);
+        }
+
+        ShaderLibrary::ShaderId ShaderLibrary::addShader(const std::string& vertexName, const std::string& fragmentName, const std::vector<std::string>& features)
+        {
+            if (features.size() > MaxFeatures)
+            {
+                throw RuntimeException("Too many shader features", vertexName + " / " + fragmentName);
+            }
+
+            const size_t variants = size_t(1) << features.size();
+
+            Shader shader;
+            shader.vertexSource = preprocess(vertexName);
+            shader.fragmentSource = preprocess(fragmentName);
+            shader.features = features;
+            shader.handles.assign(variants, -1);
+            shader.programs.assign(variants, nullptr);
+
+            _shaders.push_back(std::move(shader));
+
+            return static_cast<ShaderId>(_shaders.size() - 1);
+        }
+
+        ShaderLibrary::Variant ShaderLibrary::getFeature(ShaderId shader, const std::string& feature) const
+        {
+            const auto& features = _shaders.at(shader).features;
+            const auto found = std::find(features.begin(), features.end(), feature);
+
+            if (found == features.end())
+            {
+                throw RuntimeException("Unknown shader feature", feature);
+            }
+
+            return Variant(1) << (found - features.begin());
+        }
+
+        void ShaderLibrary::addBlock(const std::string& name, GLuint binding)
+        {
+            _blocks.emplace_back(name, binding);
+        }
+
+        void ShaderLibrary::request(ShaderId shader, Variant variant)
+        {
+            Shader& entry = getShader(shader, variant);
+
+            if (entry.handles[variant] >= 0)
+            {
+                return;
+            }
+
+            std::string defines;
+
+            for (size_t feature = 0; feature < entry.features.size(); ++feature)
+            {
+                if ((variant & (Variant(1) << feature)) != 0)
+                {
+                    defines += "#define " + entry.features[feature] + " 1\n";
+                }
+            }
+
+            entry.handles[variant] = _programs.request(entry.vertexSource.c_str(), entry.fragmentSource.c_str(), defines);
+        }
+
+        ShaderProgram& ShaderLibrary::get(ShaderId shader, Variant variant)
+        {
+            ShaderProgram* program = _shaders[shader].programs[variant];
+
+            return program != nullptr
+                ? *program
+                : resolve(shader, variant);
+        }
+
+        std::string ShaderLibrary::preprocess(const std::string& name) const
+        {
+            std::vector<std::string> stack;
+            std::string output;
+
+            preprocess(name, stack, output);
+
+            return output;
+        }
+
+        ShaderLibrary::Shader& ShaderLibrary::getShader(ShaderId shader, Variant variant)
+        {
+            Shader& entry = _shaders.at(shader);
+
+            if (variant >= entry.programs.size())
+            {
+                throw RuntimeException("Invalid shader variant", std::to_string(variant));
+            }
+
+            return entry;
+        }
+
+        ShaderProgram& ShaderLibrary::resolve(ShaderId shader, Variant variant)
+        {
+            request(shader, variant);
+
+            Shader& entry = _shaders[shader];
+
+            // program cache entries never move
+            ShaderProgram& program = _programs.get(static_cast<ProgramCache::Handle>(entry.handles[variant]));
+
+            for (const auto& block : _blocks)
+            {
+                program.bindBlock(block.first.c_str(), block.second);
+            }
+
+            entry.programs[variant] = &program;
+
+            return program;
+        }
+
+        void ShaderLibrary::preprocess(const std::string& name, std::vector<std::string>& stack, std::string& output) const
+        {
+            const auto source = _sources.find(name);
+
+            if (source == _sources.end())
+            {
+                throw RuntimeException("Unknown shader source", name);
+            }
+
+            if (std::find(stack.begin(), stack.end(), name) != stack.end())
+            {
+                throw RuntimeException("Recursive shader #include", name);
+            }
+
+            stack.push_back(name);
+
+            std::istringstream input(source->second);
+            std::string line;
+
+            while (std::getline(input, line))
+            {
+                const std::string include = getIncludeName(line);
+
+                if (include.empty())
+                {
+                    output += line;
+                    output += '\n';
+                }
+                else
+                {
+                    preprocess(include, stack, output);
+                }
+            }
+
+            stack.pop_back();
+        }
+    }
+}
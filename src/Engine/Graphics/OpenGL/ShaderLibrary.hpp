@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Graphics/OpenGL/ProgramCache.hpp>
+#include <Engine/Graphics/OpenGL/ShaderProgram.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        // One shader source, many programs: every feature is a #define that can be on or off,
+        // a variant is the bitmask of the features that are on.
+        //
+        // - sources are registered by name, #include "name" pulls one into another (resolved once, in addShader)
+        // - nothing compiles until a variant is requested, then it goes through the program cache
+        // - every shader has a table with one slot per variant: get() is a single array index once resolved
+        class ShaderLibrary
+        {
+        public:
+
+            using ShaderId = uint32_t;
+            using Variant = uint32_t;
+
+            // 256 slots per shader
+            static constexpr size_t MaxFeatures = 8;
+
+            explicit ShaderLibrary(ProgramCache& programs);
+
+            void addSource(const std::string& name, const std::string& text);
+
+            // native: any path, web: the file has to be prepared by the ResourceProvider first
+            void loadSource(const std::string& name, const std::string& path);
+
+            // the entry points need a #version line, included sources must not have one
+            ShaderId addShader(const std::string& vertexName, const std::string& fragmentName, const std::vector<std::string>& features = {});
+
+            Variant getFeature(ShaderId shader, const std::string& feature) const;
+
+            // every variant that declares the block gets the binding point when it's linked
+            void addBlock(const std::string& name, GLuint binding);
+
+            // starts compiling a variant without waiting for it
+            void request(ShaderId shader, Variant variant);
+
+            // waits for the variant the first time, requests it if nobody did (no bounds checks after that)
+            ShaderProgram& get(ShaderId shader, Variant variant);
+
+            std::string preprocess(const std::string& name) const;
+
+        private:
+
+            struct Shader
+            {
+                std::string vertexSource;
+                std::string fragmentSource;
+                std::vector<std::string> features;
+
+                std::vector<int64_t> handles;           // ProgramCache handle, -1 if not requested
+                std::vector<ShaderProgram*> programs;   // nullptr until linked
+            };
+
+            ProgramCache& _programs;
+            std::unordered_map<std::string, std::string> _sources;
+            std::vector<std::pair<std::string, GLuint>> _blocks;
+            std::vector<Shader> _shaders;
+
+            Shader& getShader(ShaderId shader, Variant variant);
+            ShaderProgram& resolve(ShaderId shader, Variant variant);
+            void preprocess(const std::string& name, std::vector<std::string>& stack, std::string& output) const;
+        };
+    }
+}
@@ -0,0 +1,377 @@
+#include "ShaderProgram.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <Engine/Exceptions/RuntimeException.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        constexpr ShaderProgram::Handle ShaderProgram::InvalidHandle;
+        constexpr size_t ShaderProgram::MaxCachedBytes;
+
+        namespace
+        {
+            // FNV-1a, seeded
+            uint32_t hash(const char* text, uint32_t seed) noexcept
+            {
+                uint32_t result = 2166136261u ^ seed;
+
+                for (; *text != '\0'; ++text)
+                {
+                    result ^= static_cast<uint8_t>(*text);
+                    result *= 16777619u;
+                }
+
+                return result ^ (result >> 15);
+            }
+
+            uint32_t nextPowerOfTwo(uint32_t value) noexcept
+            {
+                uint32_t result = 1;
+
+                while (result < value)
+                {
+                    result <<= 1;
+                }
+
+                return result;
+            }
+
+            // GL names arrays "lights[0]": "lights" finds them by their plain name.
+            // Only the trailing "[0]", "lights[0].color" and "lights[1].color" are different uniforms
+            std::string getBaseName(const char* name)
+            {
+                std::string result = name;
+                const size_t length = result.size();
+
+                if (length > 3 && result.compare(length - 3, 3, "[0]") == 0)
+                {
+                    result.resize(length - 3);
+                }
+
+                return result;
+            }
+
+            template<typename TVariable>
+            bool contains(const std::vector<TVariable>& variables, const std::string& name) noexcept
+            {
+                return std::any_of(variables.begin(), variables.end(), [&name](const TVariable& variable)
+                {
+                    return variable.name == name;
+                });
+            }
+        }
+
+        void ShaderProgram::PerfectHashTable::build(const std::vector<Variable>& variables)
+        {
+            const auto count = static_cast<uint32_t>(variables.size());
+            uint32_t size = nextPowerOfTwo(count * 2 + 1);
+
+            // at most 16 slots per name: past that the names can't be told apart (duplicates)
+            const uint32_t maxSize = nextPowerOfTwo(count * 16 + 1);
+
+            // a handful of names: trying seeds is instant, grow the table if unlucky
+            for (; size <= maxSize; size <<= 1)
+            {
+                mask = size - 1;
+
+                for (seed = 0; seed < 64; ++seed)
+                {
+                    slots.assign(size, -1);
+                    bool collision = false;
+
+                    for (uint32_t i = 0; i < count && !collision; ++i)
+                    {
+                        int32_t& slot = slots[hash(variables[i].name.c_str(), seed) & mask];
+                        collision = slot != -1;
+                        slot = static_cast<int32_t>(i);
+                    }
+
+                    if (!collision)
+                    {
+                        return;
+                    }
+                }
+            }
+
+            throw RuntimeException("Can't build the shader variable table", std::to_string(count) + " names, duplicates?");
+        }
+
+        int32_t ShaderProgram::PerfectHashTable::find(const std::vector<Variable>& variables, const char* name) const noexcept
+        {
+            if (slots.empty())
+            {
+                return -1;
+            }
+
+            const int32_t index = slots[hash(name, seed) & mask];
+
+            return index != -1 && variables[static_cast<size_t>(index)].name == name
+                ? index
+                : -1;
+        }
+
+        ShaderProgram::ShaderProgram()
+            : _program(0)
+            , _uploadCount(0)
+            , _skippedUploadCount(0)
+        {
+        }
+
+        ShaderProgram::~ShaderProgram()
+        {
+            release();
+        }
+
+        ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept
+            : _program(other._program)
+            , _uniforms(std::move(other._uniforms))
+            , _uniformCache(std::move(other._uniformCache))
+            , _uniformTable(std::move(other._uniformTable))
+            , _attributes(std::move(other._attributes))
+            , _attributeTable(std::move(other._attributeTable))
+            , _uploadCount(other._uploadCount)
+            , _skippedUploadCount(other._skippedUploadCount)
+        {
+            other._program = 0;
+        }
+
+        ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+
+                _program = other._program;
+                _uniforms = std::move(other._uniforms);
+                _uniformCache = std::move(other._uniformCache);
+                _uniformTable = std::move(other._uniformTable);
+                _attributes = std::move(other._attributes);
+                _attributeTable = std::move(other._attributeTable);
+                _uploadCount = other._uploadCount;
+                _skippedUploadCount = other._skippedUploadCount;
+
+                other._program = 0;
+            }
+
+            return *this;
+        }
+
+        void ShaderProgram::release() noexcept
+        {
+            if (_program != 0)
+            {
+                glDeleteProgram(_program);
+                _program = 0;
+            }
+        }
+
+        void ShaderProgram::create(const char* vertexSource, const char* fragmentSource)
+        {
+            create(compileProgram(vertexSource, fragmentSource));
+        }
+
+        void ShaderProgram::create(GLuint program)
+        {
+            release();
+
+            _program = program;
+            reflect();
+        }
+
+        void ShaderProgram::reflect()
+        {
+            GLint count = 0;
+            GLint maxLength = 0;
+
+            // uniforms
+            GL(glGetProgramiv(_program, GL_ACTIVE_UNIFORMS, &count));
+            GL(glGetProgramiv(_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+
+            std::vector<char> name(static_cast<size_t>(std::max(maxLength, 1)));
+
+            _uniforms.clear();
+
+            for (GLint i = 0; i < count; ++i)
+            {
+                Variable variable;
+                GL(glGetActiveUniform(_program, static_cast<GLuint>(i), maxLength, nullptr, &variable.size, &variable.type, name.data()));
+
+                // uniforms inside blocks don't have a location
+                variable.location = GL(glGetUniformLocation(_program, name.data()));
+
+                variable.name = getBaseName(name.data());
+
+                if (variable.location != -1 && !contains(_uniforms, variable.name))
+                {
+                    _uniforms.push_back(variable);
+                }
+            }
+
+            _uniformCache.assign(_uniforms.size(), UniformCache());
+            _uniformTable.build(_uniforms);
+
+            // attributes
+            GL(glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTES, &count));
+            GL(glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength));
+
+            name.resize(static_cast<size_t>(std::max(maxLength, 1)));
+
+            _attributes.clear();
+
+            for (GLint i = 0; i < count; ++i)
+            {
+                Variable variable;
+                GL(glGetActiveAttrib(_program, static_cast<GLuint>(i), maxLength, nullptr, &variable.size, &variable.type, name.data()));
+
+                variable.location = GL(glGetAttribLocation(_program, name.data()));
+                variable.name = getBaseName(name.data());
+
+                if (!contains(_attributes, variable.name))
+                {
+                    _attributes.push_back(variable);
+                }
+            }
+
+            _attributeTable.build(_attributes);
+        }
+
+        GLuint ShaderProgram::getId() const noexcept
+        {
+            return _program;
+        }
+
+        void ShaderProgram::use() const
+        {
+            GL(glUseProgram(_program));
+        }
+
+        ShaderProgram::Handle ShaderProgram::getUniform(const char* name) const noexcept
+        {
+            return _uniformTable.find(_uniforms, name);
+        }
+
+        GLint ShaderProgram::getUniformLocation(const char* name) const noexcept
+        {
+            const Handle uniform = getUniform(name);
+
+            return uniform != InvalidHandle
+                ? _uniforms[static_cast<size_t>(uniform)].location
+                : -1;
+        }
+
+        GLint ShaderProgram::getAttributeLocation(const char* name) const noexcept
+        {
+            const int32_t attribute = _attributeTable.find(_attributes, name);
+
+            return attribute != -1
+                ? _attributes[static_cast<size_t>(attribute)].location
+                : -1;
+        }
+
+        bool ShaderProgram::bindBlock(const char* name, GLuint binding)
+        {
+            const GLuint block = GL(glGetUniformBlockIndex(_program, name));
+
+            if (block == GL_INVALID_INDEX)
+            {
+                return false;
+            }
+
+            GL(glUniformBlockBinding(_program, block, binding));
+            return true;
+        }
+
+        bool ShaderProgram::update(Handle uniform, const void* value, size_t bytes)
+        {
+            if (uniform == InvalidHandle)
+            {
+                return false;
+            }
+
+            UniformCache& cache = _uniformCache[static_cast<size_t>(uniform)];
+
+            if (cache.valid && std::memcmp(cache.value.data(), value, bytes) == 0)
+            {
+                ++_skippedUploadCount;
+                return false;
+            }
+
+            std::memcpy(cache.value.data(), value, bytes);
+            cache.valid = true;
+
+            ++_uploadCount;
+            return true;
+        }
+
+        void ShaderProgram::set(Handle uniform, GLint value)
+        {
+            if (update(uniform, &value, sizeof(value)))
+            {
+                GL(glUniform1i(_uniforms[static_cast<size_t>(uniform)].location, value));
+            }
+        }
+
+        void ShaderProgram::set(Handle uniform, GLfloat value)
+        {
+            if (update(uniform, &value, sizeof(value)))
+            {
+                GL(glUniform1f(_uniforms[static_cast<size_t>(uniform)].location, value));
+            }
+        }
+
+        void ShaderProgram::set(Handle uniform, const glm::vec2& value)
+        {
+            if (update(uniform, glm::value_ptr(value), sizeof(value)))
+            {
+                GL(glUniform2fv(_uniforms[static_cast<size_t>(uniform)].location, 1, glm::value_ptr(value)));
+            }
+        }
+
+        void ShaderProgram::set(Handle uniform, const glm::vec3& value)
+        {
+            if (update(uniform, glm::value_ptr(value), sizeof(value)))
+            {
+                GL(glUniform3fv(_uniforms[static_cast<size_t>(uniform)].location, 1, glm::value_ptr(value)));
+            }
+        }
+
+        void ShaderProgram::set(Handle uniform, const glm::vec4& value)
+        {
+            if (update(uniform, glm::value_ptr(value), sizeof(value)))
+            {
+                GL(glUniform4fv(_uniforms[static_cast<size_t>(uniform)].location, 1, glm::value_ptr(value)));
+            }
+        }
+
+        void ShaderProgram::set(Handle uniform, const glm::mat3& value)
+        {
+            if (update(uniform, glm::value_ptr(value), sizeof(value)))
+            {
+                GL(glUniformMatrix3fv(_uniforms[static_cast<size_t>(uniform)].location, 1, GL_FALSE, glm::value_ptr(value)));
+            }
+        }
+
+        void ShaderProgram::set(Handle uniform, const glm::mat4& value)
+        {
+            if (update(uniform, glm::value_ptr(value), sizeof(value)))
+            {
+                GL(glUniformMatrix4fv(_uniforms[static_cast<size_t>(uniform)].location, 1, GL_FALSE, glm::value_ptr(value)));
+            }
+        }
+
+        uint64_t ShaderProgram::getUploadCount() const noexcept
+        {
+            return _uploadCount;
+        }
+
+        uint64_t ShaderProgram::getSkippedUploadCount() const noexcept
+        {
+            return _skippedUploadCount;
+        }
+    }
+}
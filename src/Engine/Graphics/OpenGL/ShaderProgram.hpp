@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        // Linked program plus every active uniform and attribute, reflected once at link time.
+        // Lookups by name never reach the driver: they go through a perfect hash table.
+        // Uniform setters remember the last value and skip uploads that wouldn't change anything.
+        class ShaderProgram
+        {
+        public:
+
+            using Handle = int32_t;
+            static constexpr Handle InvalidHandle = -1;
+
+            ShaderProgram();
+            ~ShaderProgram();
+
+            ShaderProgram(ShaderProgram&& other) noexcept;
+            ShaderProgram& operator=(ShaderProgram&& other) noexcept;
+            ShaderProgram(const ShaderProgram&) = delete;
+            ShaderProgram& operator=(const ShaderProgram&) = delete;
+
+            void create(const char* vertexSource, const char* fragmentSource);
+
+            // takes ownership of an already linked program
+            void create(GLuint program);
+
+            GLuint getId() const noexcept;
+            void use() const;
+
+            Handle getUniform(const char* name) const noexcept;
+            GLint getUniformLocation(const char* name) const noexcept;
+            GLint getAttributeLocation(const char* name) const noexcept;
+
+            // uniform blocks keep their binding point for the lifetime of the program, false if there is no such block
+            bool bindBlock(const char* name, GLuint binding);
+
+            // the program must be in use (GL requirement)
+            void set(Handle uniform, GLint value);
+            void set(Handle uniform, GLfloat value);
+            void set(Handle uniform, const glm::vec2& value);
+            void set(Handle uniform, const glm::vec3& value);
+            void set(Handle uniform, const glm::vec4& value);
+            void set(Handle uniform, const glm::mat3& value);
+            void set(Handle uniform, const glm::mat4& value);
+
+            template<typename TValue>
+            void set(const char* name, const TValue& value)
+            {
+                set(getUniform(name), value);
+            }
+
+            uint64_t getUploadCount() const noexcept;
+            uint64_t getSkippedUploadCount() const noexcept;
+
+        private:
+
+            static constexpr size_t MaxCachedBytes = sizeof(glm::mat4);
+
+            struct Variable
+            {
+                std::string name;
+                GLint location;
+                GLenum type;
+                GLint size;
+            };
+
+            struct UniformCache
+            {
+                std::array<uint8_t, MaxCachedBytes> value;
+                bool valid = false;
+            };
+
+            // open addressing free: every name has its own slot for the chosen seed
+            struct PerfectHashTable
+            {
+                uint32_t seed = 0;
+                uint32_t mask = 0;
+                std::vector<int32_t> slots; // index into the variables, -1 if empty
+
+                void build(const std::vector<Variable>& variables);
+                int32_t find(const std::vector<Variable>& variables, const char* name) const noexcept;
+            };
+
+            GLuint _program;
+
+            std::vector<Variable> _uniforms;
+            std::vector<UniformCache> _uniformCache;
+            PerfectHashTable _uniformTable;
+
+            std::vector<Variable> _attributes;
+            PerfectHashTable _attributeTable;
+
+            uint64_t _uploadCount;
+            uint64_t _skippedUploadCount;
+
+            void reflect();
+            void release() noexcept;
+
+            // returns false if the value is already there
+            bool update(Handle uniform, const void* value, size_t bytes);
+        };
+    }
+}
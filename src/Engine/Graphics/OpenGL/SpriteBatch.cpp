@@ -0,0 +1,315 @@
+#include "SpriteBatch.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace isc
+{
+    namespace gl
+    {
+        constexpr GLuint SpriteBatch::NoTexture;
+
+        static_assert(sizeof(Sprite) == 40, "Sprite is uploaded as is, the attribute layout depends on it");
+
+        namespace
+        {
+            enum Attribute : GLuint
+            {
+                Corner = 0,
+                Rect = 1,       // position.xy, size.xy
+                UV = 2,
+                Color = 3,
+                Rotation = 4,
+            };
+
+            const GLchar* vertexSource = "#version 300 es\n" R"SHADER_END(
+
+                layout(location = 0) in vec2 corner;
+                layout(location = 1) in vec4 rect;
+                layout(location = 2) in vec4 uvRect;
+                layout(location = 3) in vec4 tint;
+                layout(location = 4) in float rotation;
+
+                uniform mat4 projection;
+
+                out vec2 UV;
+                out vec4 color;
+
+                void main()
+                {
+                    vec2 local = (corner - 0.5) * rect.zw;
+                    float s = sin(rotation);
+                    float c = cos(rotation);
+
+                    vec2 position = rect.xy + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+
+                    UV = mix(uvRect.xy, uvRect.zw, corner);
+                    color = tint;
+
+                    gl_Position = projection * vec4(position, 0.0, 1.0);
+                }
+
+            )SHADER_END";
+
+            const GLchar* fragmentSource = "#version 300 es\n" R"SHADER_END(
+
+                precision mediump float;
+
+                in vec2 UV;
+                in vec4 color;
+                out vec4 fragmentColor;
+
+                uniform sampler2D diffuseTexture;
+
+                void main()
+                {
+                    fragmentColor = texture(diffuseTexture, UV) * color;
+                }
+
+            )SHADER_END";
+        }
+
+        SpriteBatch::SpriteBatch(size_t capacity)
+            : _projectionUniform(ShaderProgram::InvalidHandle)
+            , _vao(0)
+            , _quadBuffer(0)
+            , _instanceBuffer(0)
+            , _whiteTexture(0)
+            , _instanceCapacity(std::max<size_t>(capacity, 1))
+            , _projection(1.f)
+            , _binCount(0)
+            , _lastBin(0)
+            , _spriteCount(0)
+            , _drawCallCount(0)
+        {
+        }
+
+        SpriteBatch::~SpriteBatch()
+        {
+            if (_vao != 0)
+            {
+                glDeleteVertexArrays(1, &_vao);
+                glDeleteBuffers(1, &_quadBuffer);
+                glDeleteBuffers(1, &_instanceBuffer);
+                glDeleteTextures(1, &_whiteTexture);
+            }
+        }
+
+        void SpriteBatch::init(StateCache& state)
+        {
+            _program.create(vertexSource, fragmentSource);
+            _projectionUniform = _program.getUniform("projection");
+
+            // unit quad, drawn as a triangle strip
+            const GLfloat corners[] = {
+                0.f, 0.f, 1.f, 0.f,
+                0.f, 1.f, 1.f, 1.f
+            };
+
+            GL(glGenVertexArrays(1, &_vao));
+            GL(glGenBuffers(1, &_quadBuffer));
+            GL(glGenBuffers(1, &_instanceBuffer));
+
+            state.bindVertexArray(_vao);
+
+            state.bindBuffer(GL_ARRAY_BUFFER, _quadBuffer);
+            GL(glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW));
+            GL(glEnableVertexAttribArray(Corner));
+            GL(glVertexAttribPointer(Corner, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
+
+            state.bindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+            GL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(_instanceCapacity * sizeof(Sprite)), nullptr, GL_STREAM_DRAW));
+
+            for (GLuint attribute : { Rect, UV, Color, Rotation })
+            {
+                GL(glEnableVertexAttribArray(attribute));
+                GL(glVertexAttribDivisor(attribute, 1));
+            }
+
+            setInstanceOffset(0);
+
+            // flat colored sprites sample this one
+            const uint32_t white = 0xFFFFFFFF;
+
+            GL(glGenTextures(1, &_whiteTexture));
+            state.bindTexture(0, GL_TEXTURE_2D, _whiteTexture);
+            GL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &white));
+            GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+            GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+        }
+
+        void SpriteBatch::setInstanceOffset(size_t firstInstance)
+        {
+            // no base instance in OpenGL ES 3.0: move the attribute pointers instead
+            const size_t base = firstInstance * sizeof(Sprite);
+            const GLsizei stride = sizeof(Sprite);
+
+            auto offset = [base](size_t member)
+            {
+                return reinterpret_cast<const void*>(base + member);
+            };
+
+            GL(glVertexAttribPointer(Rect, 4, GL_FLOAT, GL_FALSE, stride, offset(offsetof(Sprite, position))));
+            GL(glVertexAttribPointer(UV, 4, GL_FLOAT, GL_FALSE, stride, offset(offsetof(Sprite, uv))));
+            GL(glVertexAttribPointer(Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, offset(offsetof(Sprite, color))));
+            GL(glVertexAttribPointer(Rotation, 1, GL_FLOAT, GL_FALSE, stride, offset(offsetof(Sprite, rotation))));
+        }
+
+        void SpriteBatch::begin(const glm::mat4& projection)
+        {
+            _projection = projection;
+
+            for (size_t i = 0; i < _binCount; ++i)
+            {
+                _bins[i].sprites.clear();
+            }
+
+            _binCount = 0;
+            _lastBin = 0;
+            _spriteCount = 0;
+        }
+
+        SpriteBatch::Bin& SpriteBatch::getBin(GLuint texture)
+        {
+            // sprites usually come in runs of the same texture
+            if (_lastBin < _binCount && _bins[_lastBin].texture == texture)
+            {
+                return _bins[_lastBin];
+            }
+
+            for (size_t i = 0; i < _binCount; ++i)
+            {
+                if (_bins[i].texture == texture)
+                {
+                    _lastBin = i;
+                    return _bins[i];
+                }
+            }
+
+            // bins (and their memory) are kept between frames
+            if (_binCount == _bins.size())
+            {
+                _bins.emplace_back();
+            }
+
+            _lastBin = _binCount++;
+            _bins[_lastBin].texture = texture;
+
+            return _bins[_lastBin];
+        }
+
+        void SpriteBatch::draw(GLuint texture, const Sprite& sprite)
+        {
+            getBin(texture).sprites.push_back(sprite);
+            ++_spriteCount;
+        }
+
+        void SpriteBatch::upload(StateCache& state)
+        {
+            state.bindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+
+            // orphan: the driver hands out fresh storage while the GPU still reads the previous frame
+            while (_instanceCapacity < _spriteCount)
+            {
+                _instanceCapacity *= 2;
+            }
+
+            const auto capacityBytes = static_cast<GLsizeiptr>(_instanceCapacity * sizeof(Sprite));
+            GL(glBufferData(GL_ARRAY_BUFFER, capacityBytes, nullptr, GL_STREAM_DRAW));
+
+#ifndef __EMSCRIPTEN__
+            // WebGL has no buffer mapping
+            const auto bytes = static_cast<GLsizeiptr>(_spriteCount * sizeof(Sprite));
+            void* mapped = GL(glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes,
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+
+            if (mapped != nullptr)
+            {
+                auto* destination = static_cast<uint8_t*>(mapped);
+
+                for (size_t i = 0; i < _binCount; ++i)
+                {
+                    const auto& sprites = _bins[i].sprites;
+                    const size_t spriteBytes = sprites.size() * sizeof(Sprite);
+
+                    std::memcpy(destination, sprites.data(), spriteBytes);
+                    destination += spriteBytes;
+                }
+
+                // false: the content got lost (display mode change...), written again below
+                const GLboolean unmapped = GL(glUnmapBuffer(GL_ARRAY_BUFFER));
+
+                if (unmapped == GL_TRUE)
+                {
+                    return;
+                }
+            }
+#endif
+
+            size_t offset = 0;
+
+            for (size_t i = 0; i < _binCount; ++i)
+            {
+                const auto& sprites = _bins[i].sprites;
+                const size_t spriteBytes = sprites.size() * sizeof(Sprite);
+
+                GL(glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(spriteBytes), sprites.data()));
+                offset += spriteBytes;
+            }
+        }
+
+        void SpriteBatch::end(StateCache& state)
+        {
+            _drawCallCount = 0;
+
+            if (_spriteCount == 0 || _vao == 0)
+            {
+                return;
+            }
+
+            state.bindVertexArray(_vao);
+            upload(state);
+
+            state.useProgram(_program.getId());
+            _program.set(_projectionUniform, _projection);
+
+            // 2D: painter's order, no depth. The y-down projection flips the winding of the quads
+            state.setDepthTest(false);
+            state.setCullFace(false);
+            state.setBlend(true);
+            state.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+            size_t firstInstance = 0;
+
+            for (size_t i = 0; i < _binCount; ++i)
+            {
+                const Bin& bin = _bins[i];
+                const GLuint texture = bin.texture != NoTexture ? bin.texture : _whiteTexture;
+
+                state.bindTexture(0, GL_TEXTURE_2D, texture);
+                setInstanceOffset(firstInstance);
+
+                GL(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(bin.sprites.size())));
+
+                firstInstance += bin.sprites.size();
+                ++_drawCallCount;
+            }
+        }
+
+        size_t SpriteBatch::getSpriteCount() const noexcept
+        {
+            return _spriteCount;
+        }
+
+        size_t SpriteBatch::getDrawCallCount() const noexcept
+        {
+            return _drawCallCount;
+        }
+
+        uint32_t SpriteBatch::packColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a) noexcept
+        {
+            return uint32_t(r) | (uint32_t(g) << 8) | (uint32_t(b) << 16) | (uint32_t(a) << 24);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Graphics/OpenGL/ShaderProgram.hpp>
+#include <Engine/Graphics/OpenGL/StateCache.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        // 40 bytes per instance, read straight by the vertex shader
+        struct Sprite
+        {
+            glm::vec2 position;                         // center
+            glm::vec2 size;
+            glm::vec4 uv = glm::vec4(0.f, 0.f, 1.f, 1.f); // min.xy, max.xy
+            uint32_t color = 0xFFFFFFFF;                // RGBA8, R in the lowest byte
+            float rotation = 0.f;                       // radians
+        };
+
+        // Collects sprites during the frame and draws every texture (or atlas) with one glDrawArraysInstanced.
+        // All instances go to a single buffer, orphaned every frame so the GPU never waits for the previous one.
+        class SpriteBatch
+        {
+        public:
+
+            // texture 0 is a 1x1 white texture: flat colored quads
+            static constexpr GLuint NoTexture = 0;
+
+            explicit SpriteBatch(size_t capacity = 16384);
+            ~SpriteBatch();
+
+            SpriteBatch(const SpriteBatch&) = delete;
+            SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+            // requires a current GL context
+            void init(StateCache& state);
+
+            void begin(const glm::mat4& projection);
+            void draw(GLuint texture, const Sprite& sprite);
+            void end(StateCache& state);
+
+            size_t getSpriteCount() const noexcept;
+            size_t getDrawCallCount() const noexcept;
+
+            static uint32_t packColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) noexcept;
+
+        private:
+
+            struct Bin
+            {
+                GLuint texture;
+                std::vector<Sprite> sprites;
+            };
+
+            ShaderProgram _program;
+            ShaderProgram::Handle _projectionUniform;
+
+            GLuint _vao;
+            GLuint _quadBuffer;
+            GLuint _instanceBuffer;
+            GLuint _whiteTexture;
+            size_t _instanceCapacity;
+
+            glm::mat4 _projection;
+            std::vector<Bin> _bins;
+            size_t _binCount;
+            size_t _lastBin;
+
+            size_t _spriteCount;
+            size_t _drawCallCount;
+
+            Bin& getBin(GLuint texture);
+            void upload(StateCache& state);
+            void setInstanceOffset(size_t firstInstance);
+        };
+    }
+}
@@ -0,0 +1,317 @@
+#include "StateCache.hpp"
+
+namespace isc
+{
+    namespace gl
+    {
+        constexpr size_t StateCache::TextureUnits;
+        constexpr size_t StateCache::UniformBindings;
+
+        namespace
+        {
+            constexpr GLuint Unknown = ~0u;
+        }
+
+        StateCache::StateCache()
+        {
+            invalidate();
+            resetCounters();
+        }
+
+        void StateCache::invalidate() noexcept
+        {
+            _program = Unknown;
+            _vao = Unknown;
+
+            invalidateBuffers();
+            invalidateTextures();
+
+            _blend = Toggle::Unknown;
+            _blendFunc = { { Unknown, Unknown } };
+            _depthTest = Toggle::Unknown;
+            _depthMask = Toggle::Unknown;
+            _depthFunc = Unknown;
+            _cullFace = Toggle::Unknown;
+            _cullMode = Unknown;
+
+            invalidateViewport();
+        }
+
+        void StateCache::invalidateViewport() noexcept
+        {
+            _viewport = { { -1, -1, -1, -1 } };
+        }
+
+        void StateCache::invalidateTextures() noexcept
+        {
+            _activeTextureUnit = Unknown;
+
+            for (auto& unit : _textures)
+            {
+                unit.fill(Unknown);
+            }
+        }
+
+        void StateCache::invalidateBuffers() noexcept
+        {
+            _buffers.fill(Unknown);
+            _uniformRanges.fill({ Unknown, 0, 0 });
+        }
+
+        bool StateCache::change(GLuint& cached, GLuint value) noexcept
+        {
+            if (cached == value)
+            {
+                ++_elidedCount;
+                return false;
+            }
+
+            cached = value;
+            ++_issuedCount;
+            return true;
+        }
+
+        bool StateCache::change(Toggle& cached, bool enabled) noexcept
+        {
+            const Toggle value = enabled ? Toggle::Enabled : Toggle::Disabled;
+
+            if (cached == value)
+            {
+                ++_elidedCount;
+                return false;
+            }
+
+            cached = value;
+            ++_issuedCount;
+            return true;
+        }
+
+        void StateCache::useProgram(GLuint program)
+        {
+            if (change(_program, program))
+            {
+                GL(glUseProgram(program));
+            }
+        }
+
+        void StateCache::bindVertexArray(GLuint vao)
+        {
+            if (change(_vao, vao))
+            {
+                GL(glBindVertexArray(vao));
+
+                // the element array binding is part of the VAO
+                _buffers[ElementArrayBuffer] = Unknown;
+            }
+        }
+
+        void StateCache::bindBuffer(GLenum target, GLuint buffer)
+        {
+            BufferTarget index;
+
+            switch (target)
+            {
+                case GL_ARRAY_BUFFER: index = ArrayBuffer; break;
+                case GL_ELEMENT_ARRAY_BUFFER: index = ElementArrayBuffer; break;
+                case GL_PIXEL_UNPACK_BUFFER: index = PixelUnpackBuffer; break;
+                case GL_UNIFORM_BUFFER: index = UniformBuffer; break;
+
+                default:
+                {
+                    // not shadowed
+                    ++_issuedCount;
+                    GL(glBindBuffer(target, buffer));
+                    return;
+                }
+            }
+
+            if (change(_buffers[index], buffer))
+            {
+                GL(glBindBuffer(target, buffer));
+            }
+        }
+
+        void StateCache::bindUniformBuffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size)
+        {
+            if (binding < UniformBindings)
+            {
+                UniformRange& range = _uniformRanges[binding];
+
+                if (range.buffer == buffer && range.offset == offset && range.size == size)
+                {
+                    ++_elidedCount;
+                    return;
+                }
+
+                range = { buffer, offset, size };
+            }
+
+            ++_issuedCount;
+
+            if (size == 0)
+            {
+                GL(glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer));
+            }
+            else
+            {
+                GL(glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, offset, size));
+            }
+
+            // indexed binds change the generic binding too
+            _buffers[UniformBuffer] = buffer;
+        }
+
+        void StateCache::activeTexture(GLuint unit)
+        {
+            if (change(_activeTextureUnit, unit))
+            {
+                GL(glActiveTexture(GL_TEXTURE0 + unit));
+            }
+        }
+
+        void StateCache::bindTexture(GLuint unit, GLenum target, GLuint texture)
+        {
+            TextureTarget index;
+
+            switch (target)
+            {
+                case GL_TEXTURE_2D: index = Texture2D; break;
+                case GL_TEXTURE_2D_ARRAY: index = Texture2DArray; break;
+                case GL_TEXTURE_3D: index = Texture3D; break;
+                case GL_TEXTURE_CUBE_MAP: index = TextureCubeMap; break;
+
+                default:
+                {
+                    activeTexture(unit);
+
+                    ++_issuedCount;
+                    GL(glBindTexture(target, texture));
+                    return;
+                }
+            }
+
+            if (unit >= TextureUnits)
+            {
+                activeTexture(unit);
+
+                ++_issuedCount;
+                GL(glBindTexture(target, texture));
+                return;
+            }
+
+            GLuint& cached = _textures[unit][index];
+
+            if (cached == texture)
+            {
+                ++_elidedCount;
+                return;
+            }
+
+            activeTexture(unit);
+            change(cached, texture);
+            GL(glBindTexture(target, texture));
+        }
+
+        void StateCache::setCapability(GLenum capability, Toggle& cached, bool enabled)
+        {
+            if (!change(cached, enabled))
+            {
+                return;
+            }
+
+            if (enabled)
+            {
+                GL(glEnable(capability));
+            }
+            else
+            {
+                GL(glDisable(capability));
+            }
+        }
+
+        void StateCache::setBlend(bool enabled)
+        {
+            setCapability(GL_BLEND, _blend, enabled);
+        }
+
+        void StateCache::setBlendFunc(GLenum source, GLenum destination)
+        {
+            if (_blendFunc[0] == source && _blendFunc[1] == destination)
+            {
+                ++_elidedCount;
+                return;
+            }
+
+            _blendFunc = { { source, destination } };
+            ++_issuedCount;
+
+            GL(glBlendFunc(source, destination));
+        }
+
+        void StateCache::setDepthTest(bool enabled)
+        {
+            setCapability(GL_DEPTH_TEST, _depthTest, enabled);
+        }
+
+        void StateCache::setDepthMask(bool enabled)
+        {
+            if (change(_depthMask, enabled))
+            {
+                GL(glDepthMask(enabled ? GL_TRUE : GL_FALSE));
+            }
+        }
+
+        void StateCache::setDepthFunc(GLenum function)
+        {
+            if (change(_depthFunc, function))
+            {
+                GL(glDepthFunc(function));
+            }
+        }
+
+        void StateCache::setCullFace(bool enabled)
+        {
+            setCapability(GL_CULL_FACE, _cullFace, enabled);
+        }
+
+        void StateCache::setCullMode(GLenum mode)
+        {
+            if (change(_cullMode, mode))
+            {
+                GL(glCullFace(mode));
+            }
+        }
+
+        void StateCache::setViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+        {
+            const std::array<GLint, 4> viewport = { { x, y, width, height } };
+
+            if (_viewport == viewport)
+            {
+                ++_elidedCount;
+                return;
+            }
+
+            _viewport = viewport;
+            ++_issuedCount;
+
+            GL(glViewport(x, y, width, height));
+        }
+
+        uint64_t StateCache::getIssuedCount() const noexcept
+        {
+            return _issuedCount;
+        }
+
+        uint64_t StateCache::getElidedCount() const noexcept
+        {
+            return _elidedCount;
+        }
+
+        void StateCache::resetCounters() noexcept
+        {
+            _issuedCount = 0;
+            _elidedCount = 0;
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        // Shadows the GL state that changes between draws and drops calls that wouldn't change anything.
+        // Everything starts unknown, so the first call always reaches GL.
+        // Code that touches GL behind the cache's back must invalidate what it modified.
+        class StateCache
+        {
+        public:
+
+            static constexpr size_t TextureUnits = 16;
+            static constexpr size_t UniformBindings = 16;
+
+            StateCache();
+
+            StateCache(const StateCache&) = delete;
+            StateCache& operator=(const StateCache&) = delete;
+
+            void invalidate() noexcept;
+            void invalidateTextures() noexcept;
+            void invalidateBuffers() noexcept;
+            void invalidateViewport() noexcept;
+
+            void useProgram(GLuint program);
+            void bindVertexArray(GLuint vao);
+            void bindBuffer(GLenum target, GLuint buffer);
+            void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+            // size 0: the whole buffer (glBindBufferBase), also binds GL_UNIFORM_BUFFER
+            void bindUniformBuffer(GLuint binding, GLuint buffer, GLintptr offset = 0, GLsizeiptr size = 0);
+
+            void setBlend(bool enabled);
+            void setBlendFunc(GLenum source, GLenum destination);
+            void setDepthTest(bool enabled);
+            void setDepthMask(bool enabled);
+            void setDepthFunc(GLenum function);
+            void setCullFace(bool enabled);
+            void setCullMode(GLenum mode);
+            void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+            uint64_t getIssuedCount() const noexcept;
+            uint64_t getElidedCount() const noexcept;
+            void resetCounters() noexcept;
+
+        private:
+
+            enum BufferTarget
+            {
+                ArrayBuffer,
+                ElementArrayBuffer,
+                PixelUnpackBuffer,
+                UniformBuffer,
+                BufferTargetCount
+            };
+
+            enum TextureTarget
+            {
+                Texture2D,
+                Texture2DArray,
+                Texture3D,
+                TextureCubeMap,
+                TextureTargetCount
+            };
+
+            // tri-state: unknown until the first call
+            enum class Toggle : uint8_t
+            {
+                Unknown,
+                Enabled,
+                Disabled
+            };
+
+            GLuint _program;
+            GLuint _vao;
+            std::array<GLuint, BufferTargetCount> _buffers;
+
+            struct UniformRange
+            {
+                GLuint buffer;
+                GLintptr offset;
+                GLsizeiptr size;
+            };
+
+            std::array<UniformRange, UniformBindings> _uniformRanges;
+
+            GLuint _activeTextureUnit;
+            std::array<std::array<GLuint, TextureTargetCount>, TextureUnits> _textures;
+
+            Toggle _blend;
+            std::array<GLenum, 2> _blendFunc;
+            Toggle _depthTest;
+            Toggle _depthMask;
+            GLenum _depthFunc;
+            Toggle _cullFace;
+            GLenum _cullMode;
+            std::array<GLint, 4> _viewport;
+
+            uint64_t _issuedCount;
+            uint64_t _elidedCount;
+
+            // true if the call has to be issued
+            bool change(GLuint& cached, GLuint value) noexcept;
+            bool change(Toggle& cached, bool enabled) noexcept;
+
+            void setCapability(GLenum capability, Toggle& cached, bool enabled);
+            void activeTexture(GLuint unit);
+        };
+    }
+}
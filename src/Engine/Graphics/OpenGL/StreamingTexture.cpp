@@ -0,0 +1,220 @@
+#include "StreamingTexture.hpp"
+
+#include <cstring>
+
+namespace isc
+{
+    namespace gl
+    {
+        namespace
+        {
+            GLenum getPixelFormat(uint32_t bytesPerPixel)
+            {
+                return bytesPerPixel == 4
+                    ? GL_RGBA
+                    : GL_RGB;
+            }
+
+            GLint getInternalFormat(uint32_t bytesPerPixel)
+            {
+                return bytesPerPixel == 4
+                    ? GL_RGBA8
+                    : GL_RGB8;
+            }
+        }
+
+        StreamingTexture::StreamingTexture(StreamingMode mode)
+            : _mode(mode)
+            , _texture(0)
+            , _pixelBuffers{ { 0, 0 } }
+            , _currentPixelBuffer(0)
+            , _size(0, 0)
+            , _bytesPerPixel(0)
+        {
+        }
+
+        StreamingTexture::~StreamingTexture()
+        {
+            release();
+        }
+
+        void StreamingTexture::release() noexcept
+        {
+            if (_texture != 0)
+            {
+                glDeleteTextures(1, &_texture);
+                _texture = 0;
+            }
+
+            if (_pixelBuffers[0] != 0)
+            {
+                glDeleteBuffers(static_cast<GLsizei>(_pixelBuffers.size()), _pixelBuffers.data());
+                _pixelBuffers = { { 0, 0 } };
+            }
+        }
+
+        void StreamingTexture::resize(const vec2<uint32_t>& size, uint32_t bytesPerPixel)
+        {
+            if (_texture != 0 && size == _size && bytesPerPixel == _bytesPerPixel)
+            {
+                return;
+            }
+
+            if (_texture == 0)
+            {
+                GL(glGenTextures(1, &_texture));
+            }
+
+            if (_mode == StreamingMode::PixelBuffers && _pixelBuffers[0] == 0)
+            {
+                GL(glGenBuffers(static_cast<GLsizei>(_pixelBuffers.size()), _pixelBuffers.data()));
+            }
+
+            _size = size;
+            _bytesPerPixel = bytesPerPixel;
+
+            GL(glBindTexture(GL_TEXTURE_2D, _texture));
+
+            GL(glTexImage2D(GL_TEXTURE_2D, 0, getInternalFormat(_bytesPerPixel),
+                static_cast<GLsizei>(_size.x), static_cast<GLsizei>(_size.y), 0,
+                getPixelFormat(_bytesPerPixel), GL_UNSIGNED_BYTE, nullptr));
+
+            GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+            GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+            GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+            GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+            GL(glBindTexture(GL_TEXTURE_2D, 0));
+        }
+
+        size_t StreamingTexture::upload(const SDL_Surface* surface)
+        {
+            return upload(surface, { 0, 0, surface->w, surface->h });
+        }
+
+        size_t StreamingTexture::upload(const SDL_Surface* surface, const SDL_Rect& region)
+        {
+            resize(
+                { static_cast<uint32_t>(surface->w), static_cast<uint32_t>(surface->h) },
+                surface->format->BytesPerPixel);
+
+            if (region.w <= 0 || region.h <= 0)
+            {
+                return 0;
+            }
+
+            const size_t bytes = static_cast<size_t>(region.w) * static_cast<size_t>(region.h) * _bytesPerPixel;
+            const void* pixels;
+
+            if (_mode == StreamingMode::PixelBuffers)
+            {
+                // rows are packed tightly inside the buffer
+                writePixelBuffer(surface, region, bytes);
+                GL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+                pixels = nullptr; // offset inside the bound unpack buffer
+            }
+            else
+            {
+                // SDL rows are 4-byte aligned, same as the GL default unpack alignment
+                GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, surface->w));
+
+                pixels = static_cast<const uint8_t*>(surface->pixels)
+                    + region.y * surface->pitch
+                    + region.x * static_cast<int>(_bytesPerPixel);
+            }
+
+            GL(glBindTexture(GL_TEXTURE_2D, _texture));
+            GL(glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.w, region.h,
+                getPixelFormat(_bytesPerPixel), GL_UNSIGNED_BYTE, pixels));
+            GL(glBindTexture(GL_TEXTURE_2D, 0));
+
+            if (_mode == StreamingMode::PixelBuffers)
+            {
+                GL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+                GL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+            }
+            else
+            {
+                GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+            }
+
+            return bytes;
+        }
+
+        void StreamingTexture::writePixelBuffer(const SDL_Surface* surface, const SDL_Rect& region, size_t bytes)
+        {
+            // alternate buffers so the driver never waits for the previous transfer
+            _currentPixelBuffer = (_currentPixelBuffer + 1) % _pixelBuffers.size();
+
+            GL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pixelBuffers[_currentPixelBuffer]));
+
+            // orphan the old storage instead of synchronizing with it
+            GL(glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW));
+
+            const size_t rowBytes = static_cast<size_t>(region.w) * _bytesPerPixel;
+            const uint8_t* source = static_cast<const uint8_t*>(surface->pixels)
+                + region.y * surface->pitch
+                + region.x * static_cast<int>(_bytesPerPixel);
+
+#ifndef __EMSCRIPTEN__
+            void* mapped = GL(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+
+            if (mapped != nullptr)
+            {
+                uint8_t* destination = static_cast<uint8_t*>(mapped);
+
+                for (int row = 0; row < region.h; ++row)
+                {
+                    std::memcpy(destination + row * rowBytes, source + row * surface->pitch, rowBytes);
+                }
+
+                // false: the content got lost (display mode change...), written again below
+                const GLboolean unmapped = GL(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+
+                if (unmapped == GL_TRUE)
+                {
+                    return;
+                }
+            }
+#endif
+
+            // WebGL 2.0 has no buffer mapping, avoid one JS call per row when possible
+            if (rowBytes == static_cast<size_t>(surface->pitch))
+            {
+                GL(glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), source));
+                return;
+            }
+
+            for (int row = 0; row < region.h; ++row)
+            {
+                GL(glBufferSubData(GL_PIXEL_UNPACK_BUFFER,
+                    static_cast<GLintptr>(row * rowBytes), static_cast<GLsizeiptr>(rowBytes),
+                    source + row * surface->pitch));
+            }
+        }
+
+        void StreamingTexture::bind(GLuint unit) const
+        {
+            GL(glActiveTexture(GL_TEXTURE0 + unit));
+            GL(glBindTexture(GL_TEXTURE_2D, _texture));
+        }
+
+        void StreamingTexture::unbind(GLuint unit) const
+        {
+            GL(glActiveTexture(GL_TEXTURE0 + unit));
+            GL(glBindTexture(GL_TEXTURE_2D, 0));
+        }
+
+        GLuint StreamingTexture::getId() const noexcept
+        {
+            return _texture;
+        }
+
+        const vec2<uint32_t>& StreamingTexture::getSize() const noexcept
+        {
+            return _size;
+        }
+    }
+}
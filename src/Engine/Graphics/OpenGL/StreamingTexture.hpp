@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <SDL.h>
+
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Math/Vector.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        enum class StreamingMode
+        {
+            Direct,         // glTexSubImage2D straight from client memory
+            PixelBuffers,   // double-buffered GL_PIXEL_UNPACK_BUFFER, avoids stalling on the texture
+        };
+
+        // Texture that lives as long as the object and receives a new image every frame.
+        // Storage is only reallocated when the size or the pixel format changes.
+        class StreamingTexture
+        {
+        public:
+
+            explicit StreamingTexture(StreamingMode mode = StreamingMode::Direct);
+            ~StreamingTexture();
+
+            StreamingTexture(const StreamingTexture&) = delete;
+            StreamingTexture& operator=(const StreamingTexture&) = delete;
+
+            void resize(const vec2<uint32_t>& size, uint32_t bytesPerPixel = 4);
+
+            // returns the amount of bytes sent to the GPU
+            size_t upload(const SDL_Surface* surface);
+            size_t upload(const SDL_Surface* surface, const SDL_Rect& region);
+
+            void bind(GLuint unit = 0) const;
+            void unbind(GLuint unit = 0) const;
+
+            GLuint getId() const noexcept;
+            const vec2<uint32_t>& getSize() const noexcept;
+
+        private:
+
+            StreamingMode _mode;
+            GLuint _texture;
+            std::array<GLuint, 2> _pixelBuffers;
+            size_t _currentPixelBuffer;
+
+            vec2<uint32_t> _size;
+            uint32_t _bytesPerPixel;
+
+            void release() noexcept;
+            void writePixelBuffer(const SDL_Surface* surface, const SDL_Rect& region, size_t bytes);
+        };
+    }
+}
@@ -0,0 +1,432 @@
+#include "TextureAtlas.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include <Engine/Exceptions/RuntimeException.hpp>
+#include <Engine/SDL/Object.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        namespace
+        {
+            constexpr uint32_t IndexMagic = 0x41435349; // "ISCA"
+            constexpr uint32_t IndexVersion = 1;
+
+            std::string getIndexPath(const std::string& name)
+            {
+                return name + ".atlas";
+            }
+
+            std::string getPagePath(const std::string& name, size_t page)
+            {
+                return name + "." + std::to_string(page) + ".bmp";
+            }
+
+            // 4 bytes per pixel, R first in memory: what glTexSubImage2D expects for GL_RGBA
+            sdl::Object<SDL_Surface> toRGBA(const SDL_Surface* image)
+            {
+                return sdl::makeObject<SDL_Surface>(
+                    SDL_ConvertSurfaceFormat(const_cast<SDL_Surface*>(image), SDL_PIXELFORMAT_RGBA32, 0),
+                    SDL_FreeSurface);
+            }
+
+            sdl::Object<SDL_Surface> loadRGBA(const std::string& path)
+            {
+                auto image = sdl::makeObject<SDL_Surface>(SDL_LoadBMP(path.c_str()), SDL_FreeSurface);
+                return toRGBA(image.get());
+            }
+        }
+
+        TextureAtlas::TextureAtlas(const vec2<uint32_t>& pageSize, size_t maxPages)
+            : _pageSize(pageSize)
+            , _maxPages(std::max<size_t>(maxPages, 1))
+            , _clock(0)
+        {
+        }
+
+        TextureAtlas::~TextureAtlas()
+        {
+            for (Page& page : _pages)
+            {
+                if (page.texture != 0)
+                {
+                    glDeleteTextures(1, &page.texture);
+                }
+            }
+        }
+
+        size_t TextureAtlas::pack(const std::vector<AtlasImage>& images, const vec2<uint32_t>& pageSize, const std::string& name)
+        {
+            std::vector<sdl::Object<SDL_Surface>> sources;
+
+            for (const AtlasImage& image : images)
+            {
+                sources.push_back(loadRGBA(image.path));
+            }
+
+            // tallest first packs noticeably tighter on a skyline
+            std::vector<size_t> order(images.size());
+            std::iota(order.begin(), order.end(), size_t(0));
+
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+            {
+                return sources[a]->h != sources[b]->h
+                    ? sources[a]->h > sources[b]->h
+                    : sources[a]->w > sources[b]->w;
+            });
+
+            std::vector<SkylinePacker> packers;
+            std::vector<sdl::Object<SDL_Surface>> pages;
+            std::vector<std::pair<uint32_t, SDL_Rect>> rects(images.size());
+
+            for (size_t index : order)
+            {
+                SDL_Surface* source = sources[index].get();
+                nonstd::optional<SDL_Rect> rect;
+                size_t page = 0;
+
+                for (; page < packers.size() && !rect; ++page)
+                {
+                    rect = packers[page].insert(static_cast<uint32_t>(source->w), static_cast<uint32_t>(source->h));
+                }
+
+                if (!rect)
+                {
+                    packers.emplace_back(pageSize);
+                    pages.push_back(sdl::makeObject<SDL_Surface>(
+                        SDL_CreateRGBSurfaceWithFormat(0, static_cast<int>(pageSize.x), static_cast<int>(pageSize.y), 32, SDL_PIXELFORMAT_RGBA32),
+                        SDL_FreeSurface));
+
+                    rect = packers.back().insert(static_cast<uint32_t>(source->w), static_cast<uint32_t>(source->h));
+                    page = packers.size();
+
+                    if (!rect)
+                    {
+                        throw RuntimeException("Image doesn't fit in an atlas page", images[index].path);
+                    }
+                }
+
+                // copy the alpha channel as is
+                SDL_Rect destination = *rect;
+                SDL_SetSurfaceBlendMode(source, SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(source, nullptr, pages[page - 1].get(), &destination);
+
+                rects[index] = { static_cast<uint32_t>(page - 1), *rect };
+            }
+
+            for (size_t page = 0; page < pages.size(); ++page)
+            {
+                if (SDL_SaveBMP(pages[page].get(), getPagePath(name, page).c_str()) != 0)
+                {
+                    throw RuntimeException("Error saving atlas page", SDL_GetError());
+                }
+            }
+
+            auto index = sdl::makeObject<SDL_RWops>(SDL_RWFromFile(getIndexPath(name).c_str(), "wb"), [](SDL_RWops* file) { SDL_RWclose(file); });
+
+            SDL_WriteLE32(index.get(), IndexMagic);
+            SDL_WriteLE32(index.get(), IndexVersion);
+            SDL_WriteLE32(index.get(), pageSize.x);
+            SDL_WriteLE32(index.get(), pageSize.y);
+            SDL_WriteLE32(index.get(), static_cast<uint32_t>(pages.size()));
+            SDL_WriteLE32(index.get(), static_cast<uint32_t>(images.size()));
+
+            for (size_t i = 0; i < images.size(); ++i)
+            {
+                const SDL_Rect& rect = rects[i].second;
+
+                SDL_WriteLE32(index.get(), images[i].id);
+                SDL_WriteLE32(index.get(), rects[i].first);
+                SDL_WriteLE32(index.get(), static_cast<uint32_t>(rect.x));
+                SDL_WriteLE32(index.get(), static_cast<uint32_t>(rect.y));
+                SDL_WriteLE32(index.get(), static_cast<uint32_t>(rect.w));
+                SDL_WriteLE32(index.get(), static_cast<uint32_t>(rect.h));
+            }
+
+            return pages.size();
+        }
+
+        void TextureAtlas::request(ResourceProvider& provider, const std::string& name, size_t pageCount)
+        {
+            provider.add(getIndexPath(name));
+
+            for (size_t page = 0; page < pageCount; ++page)
+            {
+                provider.add(getPagePath(name, page));
+            }
+        }
+
+        void TextureAtlas::load(StateCache& state, const std::string& name)
+        {
+            auto index = sdl::makeObject<SDL_RWops>(SDL_RWFromFile(getIndexPath(name).c_str(), "rb"), [](SDL_RWops* file) { SDL_RWclose(file); });
+
+            if (SDL_ReadLE32(index.get()) != IndexMagic || SDL_ReadLE32(index.get()) != IndexVersion)
+            {
+                throw RuntimeException("Invalid atlas index", getIndexPath(name));
+            }
+
+            const vec2<uint32_t> pageSize = { SDL_ReadLE32(index.get()), SDL_ReadLE32(index.get()) };
+            const uint32_t pageCount = SDL_ReadLE32(index.get());
+            const uint32_t regionCount = SDL_ReadLE32(index.get());
+
+            if (pageSize != _pageSize)
+            {
+                throw RuntimeException("Atlas page size mismatch", getIndexPath(name));
+            }
+
+            // offline pages are appended, their free space isn't known so nothing else goes in them
+            const auto firstPage = static_cast<uint32_t>(_pages.size());
+
+            for (uint32_t i = 0; i < pageCount; ++i)
+            {
+                auto image = loadRGBA(getPagePath(name, i));
+
+                _pages.emplace_back();
+                Page& page = _pages.back();
+                page.packer = SkylinePacker(_pageSize, 0);
+                page.packer.insert(_pageSize.x, _pageSize.y);
+                page.lastUse = ++_clock;
+
+                createTexture(state, page);
+                upload(state, page, { 0, 0, image->w, image->h }, image.get());
+            }
+
+            for (uint32_t i = 0; i < regionCount; ++i)
+            {
+                const uint32_t id = SDL_ReadLE32(index.get());
+                const uint32_t page = firstPage + SDL_ReadLE32(index.get());
+
+                SDL_Rect rect;
+                rect.x = static_cast<int>(SDL_ReadLE32(index.get()));
+                rect.y = static_cast<int>(SDL_ReadLE32(index.get()));
+                rect.w = static_cast<int>(SDL_ReadLE32(index.get()));
+                rect.h = static_cast<int>(SDL_ReadLE32(index.get()));
+
+                if (page >= _pages.size())
+                {
+                    throw RuntimeException("Invalid atlas index", getIndexPath(name));
+                }
+
+                _pages[page].ids.push_back(id);
+                _regions[id] = makeRegion(page, rect);
+            }
+        }
+
+        nonstd::optional<AtlasRegion> TextureAtlas::insert(StateCache& state, uint32_t id, const SDL_Surface* image)
+        {
+            // wouldn't even fit an empty page: checked before a live page gets recycled for nothing
+            if (static_cast<uint32_t>(image->w) + SkylinePacker::DefaultPadding > _pageSize.x
+                || static_cast<uint32_t>(image->h) + SkylinePacker::DefaultPadding > _pageSize.y)
+            {
+                return nonstd::nullopt;
+            }
+
+            nonstd::optional<SDL_Rect> rect;
+            uint32_t page = 0;
+
+            for (; page < _pages.size(); ++page)
+            {
+                rect = _pages[page].packer.insert(static_cast<uint32_t>(image->w), static_cast<uint32_t>(image->h));
+
+                if (rect)
+                {
+                    break;
+                }
+            }
+
+            if (!rect)
+            {
+                if (_pages.size() < _maxPages)
+                {
+                    _pages.emplace_back();
+                    _pages.back().packer = SkylinePacker(_pageSize);
+                    page = static_cast<uint32_t>(_pages.size() - 1);
+                }
+                else
+                {
+                    page = getRecyclablePage();
+                    evict(page);
+                }
+
+                rect = _pages[page].packer.insert(static_cast<uint32_t>(image->w), static_cast<uint32_t>(image->h));
+
+                if (!rect)
+                {
+                    return nonstd::nullopt;
+                }
+            }
+
+            Page& target = _pages[page];
+
+            if (target.texture == 0)
+            {
+                createTexture(state, target);
+            }
+
+            if (image->format->format == SDL_PIXELFORMAT_RGBA32)
+            {
+                upload(state, target, *rect, image);
+            }
+            else
+            {
+                upload(state, target, *rect, toRGBA(image).get());
+            }
+
+            // replacing: the id leaves its previous page
+            const auto existing = _regions.find(id);
+
+            if (existing != _regions.end())
+            {
+                auto& ids = _pages[existing->second.page].ids;
+                ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+            }
+
+            target.ids.push_back(id);
+            target.lastUse = ++_clock;
+
+            return _regions[id] = makeRegion(page, *rect);
+        }
+
+        nonstd::optional<AtlasRegion> TextureAtlas::find(uint32_t id)
+        {
+            const auto region = _regions.find(id);
+
+            if (region == _regions.end())
+            {
+                return nonstd::nullopt;
+            }
+
+            _pages[region->second.page].lastUse = ++_clock;
+
+            return region->second;
+        }
+
+        uint32_t TextureAtlas::getRecyclablePage() const noexcept
+        {
+            uint32_t oldest = 0;
+
+            for (uint32_t page = 1; page < _pages.size(); ++page)
+            {
+                if (_pages[page].lastUse < _pages[oldest].lastUse)
+                {
+                    oldest = page;
+                }
+            }
+
+            return oldest;
+        }
+
+        void TextureAtlas::evict(uint32_t page)
+        {
+            Page& target = _pages[page];
+
+            for (uint32_t id : target.ids)
+            {
+                _regions.erase(id);
+            }
+
+            target.ids.clear();
+            target.packer = SkylinePacker(_pageSize);
+        }
+
+        size_t TextureAtlas::trim(StateCache& state, size_t maxPages)
+        {
+            std::vector<uint32_t> order(_pages.size());
+            std::iota(order.begin(), order.end(), 0u);
+
+            // most recently used first
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+            {
+                return _pages[a].lastUse > _pages[b].lastUse;
+            });
+
+            size_t freed = 0;
+
+            for (size_t i = maxPages; i < order.size(); ++i)
+            {
+                Page& page = _pages[order[i]];
+
+                if (page.texture == 0)
+                {
+                    continue;
+                }
+
+                evict(order[i]);
+
+                GL(glDeleteTextures(1, &page.texture));
+                page.texture = 0;
+
+                ++freed;
+            }
+
+            // deleted names can be handed out again by glGenTextures
+            if (freed > 0)
+            {
+                state.invalidateTextures();
+            }
+
+            return freed;
+        }
+
+        void TextureAtlas::createTexture(StateCache& state, Page& page)
+        {
+            // transparent from the start, linear filtering would bleed garbage from the padding otherwise
+            const std::vector<uint8_t> transparent(static_cast<size_t>(_pageSize.x) * _pageSize.y * 4, 0);
+
+            GL(glGenTextures(1, &page.texture));
+
+            state.bindTexture(0, GL_TEXTURE_2D, page.texture);
+
+            GL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
+                static_cast<GLsizei>(_pageSize.x), static_cast<GLsizei>(_pageSize.y), 0,
+                GL_RGBA, GL_UNSIGNED_BYTE, transparent.data()));
+
+            GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+            GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+            GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+            GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        }
+
+        void TextureAtlas::upload(StateCache& state, Page& page, const SDL_Rect& rect, const SDL_Surface* image)
+        {
+            state.bindTexture(0, GL_TEXTURE_2D, page.texture);
+
+            GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, image->pitch / 4));
+            GL(glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x, rect.y, rect.w, rect.h, GL_RGBA, GL_UNSIGNED_BYTE, image->pixels));
+            GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+        }
+
+        AtlasRegion TextureAtlas::makeRegion(uint32_t page, const SDL_Rect& rect) const noexcept
+        {
+            const auto size = glm::vec2(_pageSize);
+
+            AtlasRegion region;
+            region.page = page;
+            region.texture = _pages[page].texture;
+            region.rect = rect;
+            region.uv = glm::vec4(
+                rect.x / size.x, rect.y / size.y,
+                (rect.x + rect.w) / size.x, (rect.y + rect.h) / size.y);
+
+            return region;
+        }
+
+        size_t TextureAtlas::getPageCount() const noexcept
+        {
+            return _pages.size();
+        }
+
+        size_t TextureAtlas::getRegionCount() const noexcept
+        {
+            return _regions.size();
+        }
+
+        const vec2<uint32_t>& TextureAtlas::getPageSize() const noexcept
+        {
+            return _pageSize;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <SDL.h>
+#include <glm/glm.hpp>
+
+#include <Engine/Extensions/Optional.hpp>
+#include <Engine/Graphics/SkylinePacker.hpp>
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Graphics/OpenGL/StateCache.hpp>
+#include <Engine/IO/ResourceProvider.hpp>
+#include <Engine/Math/Vector.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        struct AtlasRegion
+        {
+            uint32_t page;
+            GLuint texture;
+            SDL_Rect rect;
+            glm::vec4 uv;   // min.xy, max.xy (same layout as Sprite::uv)
+        };
+
+        struct AtlasImage
+        {
+            uint32_t id;
+            std::string path;   // BMP
+        };
+
+        // Packs many images into a few large textures (pages), so sprites using them can be batched together.
+        //
+        // offline: pack() writes the pages as <name>.<page>.bmp plus a binary UV index <name>.atlas
+        // runtime: load() reads them back, insert() adds glyphs/sprites to a page with glTexSubImage2D
+        //
+        // Pages are used in LRU order: when all of them are full the least recently used one is recycled,
+        // trim() frees textures under memory pressure.
+        class TextureAtlas
+        {
+        public:
+
+            explicit TextureAtlas(const vec2<uint32_t>& pageSize = { 1024, 1024 }, size_t maxPages = 8);
+            ~TextureAtlas();
+
+            TextureAtlas(const TextureAtlas&) = delete;
+            TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+            // offline: returns the number of pages written
+            static size_t pack(const std::vector<AtlasImage>& images, const vec2<uint32_t>& pageSize, const std::string& name);
+
+            // queues the index and the pages, load() once the provider is complete
+            static void request(ResourceProvider& provider, const std::string& name, size_t pageCount);
+            void load(StateCache& state, const std::string& name);
+
+            // an existing id is replaced (its old area stays used until the page is recycled)
+            nonstd::optional<AtlasRegion> insert(StateCache& state, uint32_t id, const SDL_Surface* image);
+            nonstd::optional<AtlasRegion> find(uint32_t id);
+
+            void evict(uint32_t page);
+
+            // keeps the most recently used pages, returns the number of textures freed
+            size_t trim(StateCache& state, size_t maxPages);
+
+            size_t getPageCount() const noexcept;
+            size_t getRegionCount() const noexcept;
+            const vec2<uint32_t>& getPageSize() const noexcept;
+
+        private:
+
+            struct Page
+            {
+                GLuint texture = 0;
+                SkylinePacker packer;
+                uint64_t lastUse = 0;
+                std::vector<uint32_t> ids;
+            };
+
+            vec2<uint32_t> _pageSize;
+            size_t _maxPages;
+            uint64_t _clock;
+
+            std::vector<Page> _pages;
+            std::unordered_map<uint32_t, AtlasRegion> _regions;
+
+            uint32_t getRecyclablePage() const noexcept;
+            void createTexture(StateCache& state, Page& page);
+            void upload(StateCache& state, Page& page, const SDL_Rect& rect, const SDL_Surface* image);
+            AtlasRegion makeRegion(uint32_t page, const SDL_Rect& rect) const noexcept;
+        };
+    }
+}
@@ -0,0 +1,133 @@
+#include "UniformBuffer.hpp"
+
+#include <cstring>
+
+#include <Engine/Exceptions/RuntimeException.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        constexpr size_t UniformRing::FrameCount;
+
+        UniformBuffer::UniformBuffer(size_t size)
+            : _size(size)
+            , _buffer(0)
+        {
+        }
+
+        UniformBuffer::~UniformBuffer()
+        {
+            if (_buffer != 0)
+            {
+                glDeleteBuffers(1, &_buffer);
+            }
+        }
+
+        void UniformBuffer::init(StateCache& state)
+        {
+            GL(glGenBuffers(1, &_buffer));
+            state.bindBuffer(GL_UNIFORM_BUFFER, _buffer);
+            GL(glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(_size), nullptr, GL_DYNAMIC_DRAW));
+        }
+
+        void UniformBuffer::update(StateCache& state, const void* data, size_t size)
+        {
+            if (size > _size)
+            {
+                throw RuntimeException("Uniform block larger than its buffer", std::to_string(size));
+            }
+
+            state.bindBuffer(GL_UNIFORM_BUFFER, _buffer);
+            GL(glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(size), data));
+        }
+
+        void UniformBuffer::bind(StateCache& state, GLuint binding)
+        {
+            state.bindUniformBuffer(binding, _buffer);
+        }
+
+        GLuint UniformBuffer::getBuffer() const noexcept
+        {
+            return _buffer;
+        }
+
+        UniformRing::UniformRing(size_t blockSize, size_t capacity)
+            : _blockSize(blockSize)
+            , _capacity(capacity)
+            , _stride(blockSize)
+            , _buffer(0)
+            , _frame(0)
+            , _count(0)
+        {
+        }
+
+        UniformRing::~UniformRing()
+        {
+            if (_buffer != 0)
+            {
+                glDeleteBuffers(1, &_buffer);
+            }
+        }
+
+        void UniformRing::init(StateCache& state)
+        {
+            // glBindBufferRange offsets have to be multiples of this (256 on most desktop GPUs)
+            GLint alignment = 0;
+            GL(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+
+            const auto offsetAlignment = static_cast<size_t>(alignment > 0 ? alignment : 256);
+            _stride = (_blockSize + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+            _staging.resize(_stride * _capacity);
+
+            GL(glGenBuffers(1, &_buffer));
+            state.bindBuffer(GL_UNIFORM_BUFFER, _buffer);
+            GL(glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(_staging.size() * FrameCount), nullptr, GL_DYNAMIC_DRAW));
+        }
+
+        void UniformRing::begin()
+        {
+            _frame = (_frame + 1) % FrameCount;
+            _count = 0;
+        }
+
+        UniformRing::Range UniformRing::push(const void* data)
+        {
+            if (_count == _capacity)
+            {
+                throw RuntimeException("Uniform ring full", std::to_string(_capacity) + " blocks per frame");
+            }
+
+            std::memcpy(_staging.data() + _count * _stride, data, _blockSize);
+
+            const size_t offset = (_frame * _capacity + _count) * _stride;
+            ++_count;
+
+            return { _buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(_blockSize) };
+        }
+
+        void UniformRing::flush(StateCache& state)
+        {
+            if (_count == 0)
+            {
+                return;
+            }
+
+            state.bindBuffer(GL_UNIFORM_BUFFER, _buffer);
+            GL(glBufferSubData(GL_UNIFORM_BUFFER,
+                static_cast<GLintptr>(_frame * _capacity * _stride),
+                static_cast<GLsizeiptr>(_count * _stride),
+                _staging.data()));
+        }
+
+        size_t UniformRing::getStride() const noexcept
+        {
+            return _stride;
+        }
+
+        size_t UniformRing::getCount() const noexcept
+        {
+            return _count;
+        }
+    }
+}
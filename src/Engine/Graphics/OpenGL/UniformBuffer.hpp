@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Graphics/OpenGL/StateCache.hpp>
+
+namespace isc
+{
+    namespace gl
+    {
+        // binding points shared by every program, see ShaderLibrary::addBlock()
+        enum UniformBinding : GLuint
+        {
+            CameraBinding = 0,
+            ObjectBinding = 1,
+        };
+
+        // Members with the std140 alignment baked in: a struct made of them has the same layout
+        // as the `layout(std140) uniform` block with the same members in the same order.
+        namespace std140
+        {
+            template<typename TValue, size_t Alignment>
+            struct alignas(Alignment) Member
+            {
+                TValue value;
+
+                Member& operator=(const TValue& other) noexcept
+                {
+                    value = other;
+                    return *this;
+                }
+            };
+
+            using Float = Member<float, 4>;
+            using Int = Member<int32_t, 4>;
+            using Vec2 = Member<glm::vec2, 8>;
+            using Vec3 = Member<glm::vec3, 16>;  // padded to 16 bytes: put the scalars that would fit in w elsewhere
+            using Vec4 = Member<glm::vec4, 16>;
+            using Mat4 = Member<glm::mat4, 16>;
+
+            // every column is a vec4
+            struct alignas(16) Mat3
+            {
+                glm::vec4 columns[3];
+
+                Mat3& operator=(const glm::mat3& other) noexcept
+                {
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        columns[i] = glm::vec4(other[i], 0.f);
+                    }
+
+                    return *this;
+                }
+            };
+
+            // blocks are rounded up to a vec4: arrays of them keep the same stride on both sides
+            template<typename TBlock>
+            struct IsBlock
+                : std::integral_constant<bool,
+                    std::is_standard_layout<TBlock>::value
+                    && std::is_trivially_copyable<TBlock>::value
+                    && sizeof(TBlock) % 16 == 0>
+            {
+            };
+        }
+
+        // std140 blocks matching the GLSL ones, the shader side is in the demo's "blocks.glsl"
+        struct CameraBlock
+        {
+            std140::Mat4 view;
+            std140::Mat4 projection;
+            std140::Mat4 viewProjection;
+            std140::Vec4 position;          // w: 1
+        };
+
+        struct ObjectBlock
+        {
+            std140::Mat4 model;
+            std140::Vec4 color;
+        };
+
+        static_assert(std140::IsBlock<CameraBlock>::value && sizeof(CameraBlock) == 208, "CameraBlock doesn't match std140");
+        static_assert(std140::IsBlock<ObjectBlock>::value && sizeof(ObjectBlock) == 80, "ObjectBlock doesn't match std140");
+
+        // One block for the whole frame: uploaded once, bound once, seen by every program.
+        class UniformBuffer
+        {
+        public:
+
+            explicit UniformBuffer(size_t size);
+            ~UniformBuffer();
+
+            UniformBuffer(const UniformBuffer&) = delete;
+            UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+            // requires a current GL context
+            void init(StateCache& state);
+
+            void update(StateCache& state, const void* data, size_t size);
+            void bind(StateCache& state, GLuint binding);
+
+            template<typename TBlock>
+            void update(StateCache& state, const TBlock& block)
+            {
+                static_assert(std140::IsBlock<TBlock>::value, "not a std140 block");
+                update(state, &block, sizeof(TBlock));
+            }
+
+            GLuint getBuffer() const noexcept;
+
+        private:
+
+            size_t _size;
+            GLuint _buffer;
+        };
+
+        // Per object blocks, written one after the other and uploaded with a single call per frame.
+        // The buffer holds FrameCount frames: a frame never overwrites the ranges the GPU may still be reading.
+        // Draws pick their block with glBindBufferRange (see DrawCommand::uniformOffset).
+        class UniformRing
+        {
+        public:
+
+            static constexpr size_t FrameCount = 3;
+
+            struct Range
+            {
+                GLuint buffer;
+                GLintptr offset;
+                GLsizeiptr size;
+            };
+
+            // capacity: blocks per frame
+            UniformRing(size_t blockSize, size_t capacity = 1024);
+            ~UniformRing();
+
+            UniformRing(const UniformRing&) = delete;
+            UniformRing& operator=(const UniformRing&) = delete;
+
+            // requires a current GL context
+            void init(StateCache& state);
+
+            // moves to the next frame, every range of the previous frame stays valid on the GPU
+            void begin();
+            Range push(const void* data);
+            void flush(StateCache& state);
+
+            template<typename TBlock>
+            Range push(const TBlock& block)
+            {
+                static_assert(std140::IsBlock<TBlock>::value, "not a std140 block");
+                return push(static_cast<const void*>(&block));
+            }
+
+            size_t getStride() const noexcept;
+            size_t getCount() const noexcept;
+
+        private:
+
+            size_t _blockSize;
+            size_t _capacity;
+            size_t _stride;
+            GLuint _buffer;
+
+            size_t _frame;
+            size_t _count;
+            std::vector<uint8_t> _staging;
+        };
+    }
+}
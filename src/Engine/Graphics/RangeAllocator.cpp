@@ -0,0 +1,125 @@
+#include "RangeAllocator.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace isc
+{
+    RangeAllocator::RangeAllocator(uint32_t capacity)
+        : _capacity(0)
+        , _used(0)
+    {
+        grow(capacity);
+    }
+
+    nonstd::optional<uint32_t> RangeAllocator::allocate(uint32_t size)
+    {
+        if (size == 0)
+        {
+            return nonstd::nullopt;
+        }
+
+        auto best = _free.end();
+
+        for (auto range = _free.begin(); range != _free.end(); ++range)
+        {
+            if (range->second >= size && (best == _free.end() || range->second < best->second))
+            {
+                best = range;
+
+                if (range->second == size)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (best == _free.end())
+        {
+            return nonstd::nullopt;
+        }
+
+        const uint32_t offset = best->first;
+        const uint32_t remaining = best->second - size;
+
+        _free.erase(best);
+
+        if (remaining > 0)
+        {
+            _free.emplace(offset + size, remaining);
+        }
+
+        _used += size;
+
+        return offset;
+    }
+
+    void RangeAllocator::release(uint32_t offset, uint32_t size)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+
+        _used -= size;
+
+        auto range = _free.emplace(offset, size).first;
+
+        // merge with the next range
+        auto next = std::next(range);
+
+        if (next != _free.end() && range->first + range->second == next->first)
+        {
+            range->second += next->second;
+            _free.erase(next);
+        }
+
+        // merge with the previous range
+        if (range != _free.begin())
+        {
+            auto previous = std::prev(range);
+
+            if (previous->first + previous->second == range->first)
+            {
+                previous->second += range->second;
+                _free.erase(range);
+            }
+        }
+    }
+
+    void RangeAllocator::grow(uint32_t capacity)
+    {
+        if (capacity <= _capacity)
+        {
+            return;
+        }
+
+        const uint32_t previous = _capacity;
+        _capacity = capacity;
+        _used += capacity - previous;
+
+        release(previous, capacity - previous);
+    }
+
+    uint32_t RangeAllocator::getCapacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    uint32_t RangeAllocator::getUsed() const noexcept
+    {
+        return _used;
+    }
+
+    uint32_t RangeAllocator::getLargestFree() const noexcept
+    {
+        uint32_t largest = 0;
+
+        for (const auto& range : _free)
+        {
+            largest = std::max(largest, range.second);
+        }
+
+        return largest;
+    }
+}
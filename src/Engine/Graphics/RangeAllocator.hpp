@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+#include <Engine/Extensions/Optional.hpp>
+
+namespace isc
+{
+    // Hands out [offset, offset + size) ranges of an external resource (GPU buffers), never touches memory.
+    // Free ranges are kept sorted by offset: best fit on allocation, neighbours coalesce on release.
+    class RangeAllocator
+    {
+    public:
+
+        explicit RangeAllocator(uint32_t capacity = 0);
+
+        nonstd::optional<uint32_t> allocate(uint32_t size);
+        void release(uint32_t offset, uint32_t size);
+
+        // the new space is added at the end
+        void grow(uint32_t capacity);
+
+        uint32_t getCapacity() const noexcept;
+        uint32_t getUsed() const noexcept;
+        uint32_t getLargestFree() const noexcept;
+
+    private:
+
+        uint32_t _capacity;
+        uint32_t _used;
+        std::map<uint32_t, uint32_t> _free; // offset -> size
+    };
+}
@@ -0,0 +1,156 @@
+#include "SkylinePacker.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace isc
+{
+    constexpr uint32_t SkylinePacker::DefaultPadding;
+
+    SkylinePacker::SkylinePacker(const vec2<uint32_t>& size, uint32_t padding)
+        : _size(size)
+        , _padding(padding)
+        , _usedArea(0)
+    {
+        reset();
+    }
+
+    void SkylinePacker::reset()
+    {
+        _skyline.clear();
+        _skyline.push_back({ 0, 0, _size.x });
+        _usedArea = 0;
+    }
+
+    bool SkylinePacker::fit(size_t segment, uint32_t width, uint32_t height, uint32_t& y) const noexcept
+    {
+        const uint32_t x = _skyline[segment].x;
+
+        if (x + width > _size.x)
+        {
+            return false;
+        }
+
+        // rests on the highest segment below it
+        y = 0;
+        uint32_t remaining = width;
+
+        for (size_t i = segment; remaining > 0; ++i)
+        {
+            y = std::max(y, _skyline[i].y);
+
+            if (y + height > _size.y)
+            {
+                return false;
+            }
+
+            remaining -= std::min(remaining, _skyline[i].width);
+        }
+
+        return true;
+    }
+
+    nonstd::optional<SDL_Rect> SkylinePacker::insert(uint32_t width, uint32_t height)
+    {
+        const uint32_t paddedWidth = width + _padding;
+        const uint32_t paddedHeight = height + _padding;
+
+        size_t best = _skyline.size();
+        uint32_t bestY = 0;
+        uint32_t bestTop = std::numeric_limits<uint32_t>::max();
+        uint32_t bestWidth = std::numeric_limits<uint32_t>::max();
+
+        for (size_t i = 0; i < _skyline.size(); ++i)
+        {
+            uint32_t y;
+
+            if (!fit(i, paddedWidth, paddedHeight, y))
+            {
+                continue;
+            }
+
+            // lowest top edge, then the narrowest segment (less wasted space)
+            const uint32_t top = y + paddedHeight;
+
+            if (top < bestTop || (top == bestTop && _skyline[i].width < bestWidth))
+            {
+                best = i;
+                bestY = y;
+                bestTop = top;
+                bestWidth = _skyline[i].width;
+            }
+        }
+
+        if (best == _skyline.size())
+        {
+            return nonstd::nullopt;
+        }
+
+        const uint32_t x = _skyline[best].x;
+        add(best, x, bestY, paddedWidth, paddedHeight);
+
+        _usedArea += uint64_t(paddedWidth) * paddedHeight;
+
+        return SDL_Rect{
+            static_cast<int>(x),
+            static_cast<int>(bestY),
+            static_cast<int>(width),
+            static_cast<int>(height)
+        };
+    }
+
+    void SkylinePacker::add(size_t segment, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+    {
+        _skyline.insert(_skyline.begin() + static_cast<std::ptrdiff_t>(segment), { x, y + height, width });
+
+        // shrink or remove the segments now covered by the new one
+        const uint32_t right = x + width;
+
+        for (size_t i = segment + 1; i < _skyline.size();)
+        {
+            Segment& current = _skyline[i];
+
+            if (current.x >= right)
+            {
+                break;
+            }
+
+            const uint32_t currentRight = current.x + current.width;
+
+            if (currentRight <= right)
+            {
+                _skyline.erase(_skyline.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
+            }
+
+            current.width = currentRight - right;
+            current.x = right;
+            break;
+        }
+
+        // neighbours at the same height become one segment
+        for (size_t i = 0; i + 1 < _skyline.size();)
+        {
+            if (_skyline[i].y == _skyline[i + 1].y)
+            {
+                _skyline[i].width += _skyline[i + 1].width;
+                _skyline.erase(_skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    const vec2<uint32_t>& SkylinePacker::getSize() const noexcept
+    {
+        return _size;
+    }
+
+    float SkylinePacker::getOccupancy() const noexcept
+    {
+        return static_cast<float>(static_cast<double>(_usedArea) / (uint64_t(_size.x) * _size.y));
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <SDL.h>
+
+#include <Engine/Extensions/Optional.hpp>
+#include <Engine/Math/Vector.hpp>
+
+namespace isc
+{
+    // Skyline bottom-left rectangle packer: keeps the top edge of the packed area as a list of segments
+    // and places every rectangle where it ends up lowest. Fast enough to insert glyphs at runtime.
+    class SkylinePacker
+    {
+    public:
+
+        // free pixels right and below every rectangle, linear filtering doesn't bleed between them
+        static constexpr uint32_t DefaultPadding = 1;
+
+        explicit SkylinePacker(const vec2<uint32_t>& size = { 1024, 1024 }, uint32_t padding = DefaultPadding);
+
+        void reset();
+
+        // the returned rect excludes the padding
+        nonstd::optional<SDL_Rect> insert(uint32_t width, uint32_t height);
+
+        const vec2<uint32_t>& getSize() const noexcept;
+
+        // used area / total area, padding included
+        float getOccupancy() const noexcept;
+
+    private:
+
+        struct Segment
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+        };
+
+        vec2<uint32_t> _size;
+        uint32_t _padding;
+        uint64_t _usedArea;
+        std::vector<Segment> _skyline;
+
+        // y where a rectangle starting at the segment would rest, false if it doesn't fit
+        bool fit(size_t segment, uint32_t width, uint32_t height, uint32_t& y) const noexcept;
+        void add(size_t segment, uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+    };
+}
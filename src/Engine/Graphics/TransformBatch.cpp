@@ -0,0 +1,310 @@
+#include "TransformBatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__wasm_simd128__)
+    #include <wasm_simd128.h>
+    #define ISC_SIMD_WASM
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+    #define ISC_SIMD_SSE
+
+    #if defined(__AVX2__)
+        #define ISC_SIMD_AVX2
+    #endif
+
+    // without FMA the world update is no faster than glm (the sphere update dominates), clip and cull still are
+    #if defined(__FMA__)
+        #define ISC_SIMD_WORLD
+    #endif
+#endif
+
+namespace isc
+{
+    namespace
+    {
+#if defined(ISC_SIMD_WASM)
+        using float4 = v128_t;
+
+        inline float4 load4(const float* source) noexcept { return wasm_v128_load(source); }
+        inline void store4(float* destination, float4 value) noexcept { wasm_v128_store(destination, value); }
+        inline float4 splat4(float value) noexcept { return wasm_f32x4_splat(value); }
+        inline float4 mul4(float4 a, float4 b) noexcept { return wasm_f32x4_mul(a, b); }
+        inline float4 madd4(float4 a, float4 b, float4 c) noexcept { return wasm_f32x4_add(wasm_f32x4_mul(a, b), c); }
+        inline int greaterEqual4(float4 a, float4 b) noexcept { return static_cast<int>(wasm_i32x4_bitmask(wasm_f32x4_ge(a, b))); }
+#elif defined(ISC_SIMD_SSE)
+        using float4 = __m128;
+
+        inline float4 load4(const float* source) noexcept { return _mm_loadu_ps(source); }
+        inline void store4(float* destination, float4 value) noexcept { _mm_storeu_ps(destination, value); }
+        inline float4 splat4(float value) noexcept { return _mm_set1_ps(value); }
+        inline float4 mul4(float4 a, float4 b) noexcept { return _mm_mul_ps(a, b); }
+        inline int greaterEqual4(float4 a, float4 b) noexcept { return _mm_movemask_ps(_mm_cmpge_ps(a, b)); }
+
+    #if defined(__FMA__)
+        inline float4 madd4(float4 a, float4 b, float4 c) noexcept { return _mm_fmadd_ps(a, b, c); }
+    #else
+        inline float4 madd4(float4 a, float4 b, float4 c) noexcept { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    #endif
+#endif
+
+#if defined(ISC_SIMD_WASM) || defined(ISC_SIMD_SSE)
+        #define ISC_SIMD_4
+
+        // out = a * b for every b, a stays in registers: 16 multiply-adds per matrix
+        void multiplyBatch(const glm::mat4& a, const glm::mat4* b, glm::mat4* out, size_t count) noexcept
+        {
+            const float* columns = &a[0][0];
+            const float4 a0 = load4(columns);
+            const float4 a1 = load4(columns + 4);
+            const float4 a2 = load4(columns + 8);
+            const float4 a3 = load4(columns + 12);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float* source = &b[i][0][0];
+                float* destination = &out[i][0][0];
+
+                for (int column = 0; column < 4; ++column)
+                {
+                    const float* c = source + column * 4;
+
+                    float4 result = mul4(a0, splat4(c[0]));
+                    result = madd4(a1, splat4(c[1]), result);
+                    result = madd4(a2, splat4(c[2]), result);
+                    result = madd4(a3, splat4(c[3]), result);
+
+                    store4(destination + column * 4, result);
+                }
+            }
+        }
+
+        // writes the indices whose bit is set, branch free: the output needs `width` spare slots
+        inline size_t compact(int mask, TransformBatch::Index first, TransformBatch::Index* output, size_t count, int width) noexcept
+        {
+            for (int bit = 0; bit < width; ++bit)
+            {
+                output[count] = first + static_cast<TransformBatch::Index>(bit);
+                count += static_cast<size_t>((mask >> bit) & 1);
+            }
+
+            return count;
+        }
+#endif
+
+        inline bool isVisible(const Frustum& frustum, float x, float y, float z, float radius) noexcept
+        {
+            for (const glm::vec4& plane : frustum.planes)
+            {
+                if (plane.x * x + plane.y * y + plane.z * z + plane.w < -radius)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    const char* TransformBatch::getInstructionSet() noexcept
+    {
+#if defined(ISC_SIMD_AVX2)
+        return "AVX2 + SSE";
+#elif defined(ISC_SIMD_SSE)
+        return "SSE";
+#elif defined(ISC_SIMD_WASM)
+        return "WASM SIMD128";
+#else
+        return "scalar";
+#endif
+    }
+
+    TransformBatch::Index TransformBatch::add(const glm::mat4& local, const glm::vec3& center, float radius)
+    {
+        _locals.push_back(local);
+        _worlds.push_back(local);
+        _clips.push_back(local);
+        _spheres.emplace_back(center, radius);
+
+        _x.push_back(center.x);
+        _y.push_back(center.y);
+        _z.push_back(center.z);
+        _radius.push_back(radius);
+
+        return static_cast<Index>(_locals.size() - 1);
+    }
+
+    void TransformBatch::setLocal(Index index, const glm::mat4& local) noexcept
+    {
+        _locals[index] = local;
+    }
+
+    void TransformBatch::clear() noexcept
+    {
+        _locals.clear();
+        _worlds.clear();
+        _clips.clear();
+        _spheres.clear();
+        _x.clear();
+        _y.clear();
+        _z.clear();
+        _radius.clear();
+    }
+
+    void TransformBatch::update(const glm::mat4& parent)
+    {
+#if defined(ISC_SIMD_WORLD)
+        multiplyBatch(parent, _locals.data(), _worlds.data(), _locals.size());
+
+        for (size_t i = 0; i < _locals.size(); ++i)
+        {
+            updateSphere(i);
+        }
+#else
+        updateScalar(parent);
+#endif
+    }
+
+    void TransformBatch::updateClip(const glm::mat4& viewProjection)
+    {
+#if defined(ISC_SIMD_4)
+        multiplyBatch(viewProjection, _worlds.data(), _clips.data(), _worlds.size());
+#else
+        updateClipScalar(viewProjection);
+#endif
+    }
+
+    size_t TransformBatch::cull(const Frustum& frustum, std::vector<Index>& visible) const
+    {
+        const size_t count = _x.size();
+        size_t visibleCount = 0;
+        size_t i = 0;
+
+        visible.resize(count + 8);
+
+#if defined(ISC_SIMD_AVX2)
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 x = _mm256_loadu_ps(&_x[i]);
+            const __m256 y = _mm256_loadu_ps(&_y[i]);
+            const __m256 z = _mm256_loadu_ps(&_z[i]);
+            const __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&_radius[i]));
+
+            int mask = 0xFF;
+
+            for (const glm::vec4& plane : frustum.planes)
+            {
+                __m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), x), _mm256_set1_ps(plane.w));
+                distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.y), y), distance);
+                distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), z), distance);
+
+                mask &= _mm256_movemask_ps(_mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+            }
+
+            visibleCount = compact(mask, static_cast<Index>(i), visible.data(), visibleCount, 8);
+        }
+#endif
+
+#if defined(ISC_SIMD_4)
+        for (; i + 4 <= count; i += 4)
+        {
+            const float4 x = load4(&_x[i]);
+            const float4 y = load4(&_y[i]);
+            const float4 z = load4(&_z[i]);
+            const float4 negativeRadius = mul4(load4(&_radius[i]), splat4(-1.f));
+
+            int mask = 0xF;
+
+            for (const glm::vec4& plane : frustum.planes)
+            {
+                float4 distance = madd4(splat4(plane.x), x, splat4(plane.w));
+                distance = madd4(splat4(plane.y), y, distance);
+                distance = madd4(splat4(plane.z), z, distance);
+
+                mask &= greaterEqual4(distance, negativeRadius);
+            }
+
+            visibleCount = compact(mask, static_cast<Index>(i), visible.data(), visibleCount, 4);
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            if (isVisible(frustum, _x[i], _y[i], _z[i], _radius[i]))
+            {
+                visible[visibleCount++] = static_cast<Index>(i);
+            }
+        }
+
+        visible.resize(visibleCount);
+
+        return visibleCount;
+    }
+
+    void TransformBatch::updateScalar(const glm::mat4& parent)
+    {
+        for (size_t i = 0; i < _locals.size(); ++i)
+        {
+            _worlds[i] = parent * _locals[i];
+            updateSphere(i);
+        }
+    }
+
+    void TransformBatch::updateClipScalar(const glm::mat4& viewProjection)
+    {
+        for (size_t i = 0; i < _worlds.size(); ++i)
+        {
+            _clips[i] = viewProjection * _worlds[i];
+        }
+    }
+
+    size_t TransformBatch::cullScalar(const Frustum& frustum, std::vector<Index>& visible) const
+    {
+        visible.clear();
+
+        for (size_t i = 0; i < _x.size(); ++i)
+        {
+            if (frustum.isVisible(glm::vec3(_x[i], _y[i], _z[i]), _radius[i]))
+            {
+                visible.push_back(static_cast<Index>(i));
+            }
+        }
+
+        return visible.size();
+    }
+
+    const glm::mat4& TransformBatch::getWorld(Index index) const noexcept
+    {
+        return _worlds[index];
+    }
+
+    const glm::mat4& TransformBatch::getClip(Index index) const noexcept
+    {
+        return _clips[index];
+    }
+
+    size_t TransformBatch::getCount() const noexcept
+    {
+        return _locals.size();
+    }
+
+    void TransformBatch::updateSphere(size_t index) noexcept
+    {
+        const glm::mat4& world = _worlds[index];
+        const glm::vec4& sphere = _spheres[index];
+
+        const glm::vec4 center = world * glm::vec4(glm::vec3(sphere), 1.f);
+
+        // non uniform scales: the largest axis keeps the sphere conservative
+        const float scale = std::sqrt(std::max({
+            glm::dot(glm::vec3(world[0]), glm::vec3(world[0])),
+            glm::dot(glm::vec3(world[1]), glm::vec3(world[1])),
+            glm::dot(glm::vec3(world[2]), glm::vec3(world[2])) }));
+
+        _x[index] = center.x;
+        _y[index] = center.y;
+        _z[index] = center.z;
+        _radius[index] = sphere.w * scale;
+    }
+}
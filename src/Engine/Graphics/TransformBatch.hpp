@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <Engine/Graphics/Camera.hpp>
+
+namespace isc
+{
+    // Transforms and bounding spheres of many objects, processed in batches:
+    // - matrices are contiguous (4 columns of 4 floats): one SIMD register per column
+    // - world space spheres are stored as separate x, y, z, radius arrays: one register tests 4 (or 8) spheres
+    //
+    // Kernels: AVX2 / SSE natively, SIMD128 on wasm (-msimd128), plain C++ otherwise.
+    // update() only uses them with FMA (-march=native), glm is as fast without.
+    // The *Scalar() versions use glm and give the same results, they're the reference for the benchmark.
+    class TransformBatch
+    {
+    public:
+
+        using Index = uint32_t;
+
+        static const char* getInstructionSet() noexcept;
+
+        Index add(const glm::mat4& local, const glm::vec3& center = glm::vec3(0.f), float radius = 1.f);
+        void setLocal(Index index, const glm::mat4& local) noexcept;
+        void clear() noexcept;
+
+        // world = parent * local, bounding spheres to world space
+        void update(const glm::mat4& parent);
+
+        // clip = viewProjection * world, after update()
+        void updateClip(const glm::mat4& viewProjection);
+
+        // indices of the objects whose sphere touches the frustum, in increasing order
+        size_t cull(const Frustum& frustum, std::vector<Index>& visible) const;
+
+        void updateScalar(const glm::mat4& parent);
+        void updateClipScalar(const glm::mat4& viewProjection);
+        size_t cullScalar(const Frustum& frustum, std::vector<Index>& visible) const;
+
+        const glm::mat4& getWorld(Index index) const noexcept;
+        const glm::mat4& getClip(Index index) const noexcept;
+        size_t getCount() const noexcept;
+
+    private:
+
+        std::vector<glm::mat4> _locals;
+        std::vector<glm::mat4> _worlds;
+        std::vector<glm::mat4> _clips;
+
+        // local space spheres
+        std::vector<glm::vec4> _spheres;
+
+        // world space spheres
+        std::vector<float> _x;
+        std::vector<float> _y;
+        std::vector<float> _z;
+        std::vector<float> _radius;
+
+        void updateSphere(size_t index) noexcept;
+    };
+}
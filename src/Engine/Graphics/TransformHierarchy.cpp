@@ -0,0 +1,107 @@
+#include "TransformHierarchy.hpp"
+
+#include <algorithm>
+
+#include <Engine/Exceptions/RuntimeException.hpp>
+
+namespace isc
+{
+    constexpr TransformHierarchy::Node TransformHierarchy::NoParent;
+
+    TransformHierarchy::Node TransformHierarchy::create(Node parent, const glm::mat4& local)
+    {
+        const auto node = static_cast<Node>(_parents.size());
+
+        if (parent != NoParent && parent >= node)
+        {
+            throw RuntimeException("Invalid transform parent", std::to_string(parent));
+        }
+
+        _parents.push_back(parent);
+        _locals.push_back(local);
+        _worlds.push_back(local);
+        _dirty.push_back(0);
+        _updated.push_back(0);
+
+        setLocal(node, local);
+
+        return node;
+    }
+
+    void TransformHierarchy::setLocal(Node node, const glm::mat4& local)
+    {
+        _locals[node] = local;
+
+        if (_dirty[node] == 0)
+        {
+            _dirty[node] = 1;
+            _firstDirty = _dirtyCount == 0 ? node : std::min(_firstDirty, static_cast<size_t>(node));
+            ++_dirtyCount;
+        }
+    }
+
+    const glm::mat4& TransformHierarchy::getLocal(Node node) const noexcept
+    {
+        return _locals[node];
+    }
+
+    const glm::mat4& TransformHierarchy::getWorld(Node node) const noexcept
+    {
+        return _worlds[node];
+    }
+
+    TransformHierarchy::Node TransformHierarchy::getParent(Node node) const noexcept
+    {
+        return _parents[node];
+    }
+
+    size_t TransformHierarchy::update()
+    {
+        // only the nodes of the last update have the flag
+        for (const Node node : _updatedNodes)
+        {
+            _updated[node] = 0;
+        }
+
+        _updatedNodes.clear();
+
+        if (_dirtyCount == 0)
+        {
+            return 0;
+        }
+
+        // parents come first: one pass is enough, nodes before the first dirty one can't change
+        for (size_t node = _firstDirty; node < _parents.size(); ++node)
+        {
+            const Node parent = _parents[node];
+            const bool parentUpdated = parent != NoParent && _updated[parent] != 0;
+
+            if (_dirty[node] == 0 && !parentUpdated)
+            {
+                continue;
+            }
+
+            _worlds[node] = parent != NoParent
+                ? _worlds[parent] * _locals[node]
+                : _locals[node];
+
+            _dirty[node] = 0;
+            _updated[node] = 1;
+            _updatedNodes.push_back(static_cast<Node>(node));
+        }
+
+        _dirtyCount = 0;
+
+        return _updatedNodes.size();
+    }
+
+    bool TransformHierarchy::wasUpdated(Node node) const noexcept
+    {
+        return _updated[node] != 0;
+    }
+
+    size_t TransformHierarchy::getCount() const noexcept
+    {
+        return _parents.size();
+    }
+}
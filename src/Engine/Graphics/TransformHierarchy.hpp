@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace isc
+{
+    // Local and world matrices of every node, stored flat with parents always before their children.
+    // Changing a local matrix marks the node dirty, update() recomputes the world matrices of the
+    // dirty nodes and their descendants only, starting from the first dirty node.
+    class TransformHierarchy
+    {
+    public:
+
+        using Node = uint32_t;
+        static constexpr Node NoParent = ~0u;
+
+        Node create(Node parent = NoParent, const glm::mat4& local = glm::mat4(1.f));
+
+        void setLocal(Node node, const glm::mat4& local);
+        const glm::mat4& getLocal(Node node) const noexcept;
+        const glm::mat4& getWorld(Node node) const noexcept;
+        Node getParent(Node node) const noexcept;
+
+        // returns how many world matrices were recomputed
+        size_t update();
+
+        // true if the world matrix changed in the last update()
+        bool wasUpdated(Node node) const noexcept;
+
+        size_t getCount() const noexcept;
+
+    private:
+
+        std::vector<Node> _parents;
+        std::vector<glm::mat4> _locals;
+        std::vector<glm::mat4> _worlds;
+        std::vector<uint8_t> _dirty;
+        std::vector<uint8_t> _updated;
+        std::vector<Node> _updatedNodes;
+
+        size_t _firstDirty = 0;
+        size_t _dirtyCount = 0;
+    };
+}
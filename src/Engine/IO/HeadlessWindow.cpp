@@ -0,0 +1,168 @@
+#ifdef ISC_HEADLESS
+
+#include "HeadlessWindow.hpp"
+
+#include <string>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <SDL.h>
+
+#include <Engine/Exceptions/RuntimeException.hpp>
+#include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Debug/ProfileZone.hpp>
+
+namespace isc
+{
+    namespace
+    {
+        std::string getEGLError()
+        {
+            return "EGL error " + std::to_string(eglGetError());
+        }
+
+        void* getProcAddress(const char* name)
+        {
+            return reinterpret_cast<void*>(eglGetProcAddress(name));
+        }
+
+        EGLDisplay getDisplay()
+        {
+            // prefer a display that needs neither X11 nor Wayland
+            auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+            if (getPlatformDisplay != nullptr)
+            {
+                EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+
+                if (display != EGL_NO_DISPLAY)
+                {
+                    return display;
+                }
+            }
+
+            return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+    }
+
+    HeadlessWindow::HeadlessWindow()
+        : Window()
+        , _display(EGL_NO_DISPLAY)
+        , _surface(EGL_NO_SURFACE)
+        , _context(EGL_NO_CONTEXT)
+    {
+    }
+
+    HeadlessWindow::~HeadlessWindow()
+    {
+        if (_display == EGL_NO_DISPLAY)
+        {
+            return;
+        }
+
+        eglMakeCurrent(_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+        if (_context != EGL_NO_CONTEXT)
+        {
+            eglDestroyContext(_display, _context);
+        }
+
+        if (_surface != EGL_NO_SURFACE)
+        {
+            eglDestroySurface(_display, _surface);
+        }
+
+        eglTerminate(_display);
+    }
+
+    void HeadlessWindow::create(const char* title,
+        const vec2<uint32_t>& size,
+        const SDL_WindowFlags flags)
+    {
+        // events and timers keep working, nothing is shown
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+
+        if (SDL_InitSubSystem(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0)
+        {
+            throw RuntimeException("Error initializing SDL (dummy video driver)", SDL_GetError());
+        }
+
+        _state.size = size;
+
+        initEGL();
+        configure();
+    }
+
+    void HeadlessWindow::initEGL()
+    {
+        _display = getDisplay();
+
+        if (_display == EGL_NO_DISPLAY || eglInitialize(_display, nullptr, nullptr) != EGL_TRUE)
+        {
+            throw RuntimeException("Error initializing EGL display", getEGLError());
+        }
+
+        eglBindAPI(EGL_OPENGL_ES_API);
+
+        const EGLint configAttributes[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT_KHR,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_ALPHA_SIZE, 8,
+            EGL_DEPTH_SIZE, 24,
+            EGL_NONE
+        };
+
+        EGLConfig config;
+        EGLint configCount = 0;
+
+        if (eglChooseConfig(_display, configAttributes, &config, 1, &configCount) != EGL_TRUE || configCount == 0)
+        {
+            throw RuntimeException("No EGL config for OpenGL ES 3.0 pbuffers", getEGLError());
+        }
+
+        const EGLint surfaceAttributes[] = {
+            EGL_WIDTH, static_cast<EGLint>(_state.size.x),
+            EGL_HEIGHT, static_cast<EGLint>(_state.size.y),
+            EGL_NONE
+        };
+
+        _surface = eglCreatePbufferSurface(_display, config, surfaceAttributes);
+
+        if (_surface == EGL_NO_SURFACE)
+        {
+            throw RuntimeException("Error creating EGL pbuffer", getEGLError());
+        }
+
+        // WebGL 2.0 == OpenGL ES 3.0
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_CLIENT_VERSION, 3,
+            EGL_NONE
+        };
+
+        _context = eglCreateContext(_display, config, EGL_NO_CONTEXT, contextAttributes);
+
+        if (_context == EGL_NO_CONTEXT || eglMakeCurrent(_display, _surface, _surface, _context) != EGL_TRUE)
+        {
+            throw RuntimeException("Error creating EGL context", getEGLError());
+        }
+
+        // no vsync
+        eglSwapInterval(_display, 0);
+
+        gl::link(getProcAddress);
+    }
+
+    void HeadlessWindow::swap()
+    {
+        ISC_PROFILE_SCOPE("window.swap");
+
+        GL_CHECK();
+        GL(glFinish());
+    }
+}
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#ifdef ISC_HEADLESS
+
+#include <EGL/egl.h>
+
+#include <Engine/IO/Window.hpp>
+
+namespace isc
+{
+    // Window without a screen: SDL runs on the dummy video driver and the
+    // OpenGL ES 3.0 context renders into an offscreen EGL pbuffer.
+    // Works without a GPU through Mesa (llvmpipe + EGL_MESA_platform_surfaceless).
+    class HeadlessWindow
+        : public Window
+    {
+    public:
+
+        HeadlessWindow();
+        ~HeadlessWindow() override;
+
+        void create(const char* title,
+            const vec2<uint32_t>& size,
+            const SDL_WindowFlags flags = static_cast<SDL_WindowFlags>(0)) override;
+
+        // waits for the GPU, so the frame time includes the rendering work
+        void swap() override;
+
+    private:
+
+        EGLDisplay _display;
+        EGLSurface _surface;
+        EGLContext _context;
+
+        void initEGL();
+    };
+}
+
+#endif
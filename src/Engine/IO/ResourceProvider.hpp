@@ -5,6 +5,7 @@
 #include <vector>
 
 #include <Engine/Integrations/Emscripten.hpp>
+#include <Engine/Memory/FrameArena.hpp>
 
 namespace isc
 {
@@ -36,9 +37,16 @@ namespace isc
 
         void prepare()
         {
-            std::vector<std::string> cache = { std::begin(_files), std::end(_files) };
+            // copied to frame memory: the callbacks remove the files from the list
+            FrameVector<FrameString> cache;
+            cache.reserve(_files.size());
 
-            for (const std::string& file : cache)
+            for (const std::string& file : _files)
+            {
+                cache.emplace_back(file.c_str());
+            }
+
+            for (const FrameString& file : cache)
             {
                 emscripten::prepareFile(
                     file.c_str(),
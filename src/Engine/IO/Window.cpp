@@ -5,6 +5,7 @@
 #include <Engine/SDL/Object.hpp>
 #include <Engine/SDL/EventQueue.hpp>
 #include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Debug/ProfileZone.hpp>
 
 namespace isc
 {
@@ -172,6 +173,8 @@ namespace isc
 
     void Window::swap()
     {
+        ISC_PROFILE_SCOPE("window.swap");
+
         GL_CHECK();
         SDL_GL_SwapWindow(_window.get());
     }
@@ -38,7 +38,7 @@ namespace isc
         void requestWindowed(bool borderless) noexcept;
         bool isFullScreen() const noexcept;
 
-        void swap();
+        virtual void swap();
 
     protected:
 
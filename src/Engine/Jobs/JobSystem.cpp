@@ -0,0 +1,386 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+
+// wasm without -s USE_PTHREADS=1 can't start threads
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    #define ISC_JOBS_SINGLE_THREADED
+#endif
+
+namespace isc
+{
+    namespace jobs
+    {
+        namespace
+        {
+            // the deque of the current thread
+            thread_local const JobSystem* currentSystem = nullptr;
+            thread_local size_t currentQueue = 0;
+        }
+
+        constexpr size_t JobSystem::AutoWorkerCount;
+        constexpr size_t JobSystem::NoQueue;
+        constexpr int JobSystem::SpinCount;
+
+        bool Counter::isDone() const noexcept
+        {
+            return _pending.load(std::memory_order_acquire) == 0;
+        }
+
+        JobSystem::JobSystem(size_t workerCount)
+            : _mainThread(std::this_thread::get_id())
+        {
+#ifdef ISC_JOBS_SINGLE_THREADED
+            workerCount = 0;
+#else
+            if (workerCount == AutoWorkerCount)
+            {
+                workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+            }
+
+    #ifdef ISC_MAX_WORKERS
+            // more threads than web workers in the pool would only start after returning to the browser
+            workerCount = std::min<size_t>(workerCount, ISC_MAX_WORKERS);
+    #endif
+#endif
+
+            for (size_t i = 0; i < workerCount + 1; ++i)
+            {
+                _queues.push_back(std::make_unique<Queue>());
+            }
+
+            currentSystem = this;
+            currentQueue = 0;
+
+            _workers.reserve(workerCount);
+
+            for (size_t i = 0; i < workerCount; ++i)
+            {
+                _workers.emplace_back([this, i]() { workerLoop(i + 1); });
+            }
+        }
+
+        JobSystem::~JobSystem()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_sleepMutex);
+                _stopping = true;
+            }
+
+            _sleepCondition.notify_all();
+
+            for (std::thread& worker : _workers)
+            {
+                worker.join();
+            }
+
+            // no workers: nobody else will run them
+            while (Task* task = findTask(0))
+            {
+                execute(task);
+            }
+
+            // no GL context anymore
+            for (Task* task : _mainThreadTasks)
+            {
+                delete task;
+            }
+
+            for (Task* task : _freeTasks)
+            {
+                delete task;
+            }
+
+            if (currentSystem == this)
+            {
+                currentSystem = nullptr;
+            }
+        }
+
+        void JobSystem::run(Job job, Counter& counter, Affinity affinity)
+        {
+            counter._pending.fetch_add(1, std::memory_order_relaxed);
+            schedule(createTask(std::move(job), &counter), affinity);
+        }
+
+        void JobSystem::runAfter(Counter& dependency, Job job, Counter& counter, Affinity affinity)
+        {
+            counter._pending.fetch_add(1, std::memory_order_relaxed);
+
+            {
+                std::lock_guard<std::mutex> lock(dependency._mutex);
+
+                // scheduled by finish() when the last job of the dependency is done
+                if (!dependency.isDone())
+                {
+                    dependency._continuations.push_back({ std::move(job), &counter, affinity });
+                    return;
+                }
+            }
+
+            schedule(createTask(std::move(job), &counter), affinity);
+        }
+
+        void JobSystem::wait(Counter& counter)
+        {
+            const bool mainThread = isMainThread();
+            const size_t queue = getCurrentQueue();
+
+            while (!counter.isDone())
+            {
+                if (Task* task = findTask(queue))
+                {
+                    execute(task);
+                    continue;
+                }
+
+                if (mainThread && executeMainThreadJobs() > 0)
+                {
+                    continue;
+                }
+
+                std::this_thread::yield();
+            }
+
+            // the last finish() may still hold the lock, the counter can be destroyed once it's released
+            std::lock_guard<std::mutex> lock(counter._mutex);
+        }
+
+        size_t JobSystem::getGrainSize(size_t count) const noexcept
+        {
+            if (_workers.empty())
+            {
+                return count;
+            }
+
+            return std::max<size_t>(1, count / ((_workers.size() + 1) * 8));
+        }
+
+        void JobSystem::runOnMainThread(Job job)
+        {
+            schedule(createTask(std::move(job), nullptr), Affinity::MainThread);
+        }
+
+        size_t JobSystem::executeMainThreadJobs()
+        {
+            size_t count = 0;
+
+            // no workers (single threaded wasm): the jobs nobody waits for would never run otherwise
+            if (_workers.empty() && isMainThread())
+            {
+                while (Task* task = findTask(getCurrentQueue()))
+                {
+                    execute(task);
+                    ++count;
+                }
+            }
+
+            // the batch is only in use while it has tasks: a main thread job calling wait() gets its own
+            std::vector<Task*> nested;
+            std::vector<Task*>& tasks = _mainThreadBatch.empty() ? _mainThreadBatch : nested;
+
+            {
+                std::lock_guard<std::mutex> lock(_mainThreadMutex);
+                tasks.swap(_mainThreadTasks);
+            }
+
+            // jobs posted from here on run next time
+            for (Task* task : tasks)
+            {
+                execute(task);
+            }
+
+            count += tasks.size();
+            tasks.clear();
+
+            return count;
+        }
+
+        size_t JobSystem::getWorkerCount() const noexcept
+        {
+            return _workers.size();
+        }
+
+        bool JobSystem::isMainThread() const noexcept
+        {
+            return std::this_thread::get_id() == _mainThread;
+        }
+
+        JobSystem::Task* JobSystem::createTask(Job job, Counter* counter)
+        {
+            Task* task = nullptr;
+
+            {
+                std::lock_guard<std::mutex> lock(_freeTasksMutex);
+
+                if (!_freeTasks.empty())
+                {
+                    task = _freeTasks.back();
+                    _freeTasks.pop_back();
+                }
+            }
+
+            if (task == nullptr)
+            {
+                return new Task{ std::move(job), counter };
+            }
+
+            task->job = std::move(job);
+            task->counter = counter;
+
+            return task;
+        }
+
+        void JobSystem::releaseTask(Task* task)
+        {
+            // the captures are released now, not when the task is reused
+            task->job = nullptr;
+            task->counter = nullptr;
+
+            std::lock_guard<std::mutex> lock(_freeTasksMutex);
+            _freeTasks.push_back(task);
+        }
+
+        void JobSystem::schedule(Task* task, Affinity affinity)
+        {
+            if (affinity == Affinity::MainThread)
+            {
+                std::lock_guard<std::mutex> lock(_mainThreadMutex);
+                _mainThreadTasks.push_back(task);
+                return;
+            }
+
+            _queued.fetch_add(1);
+
+            const size_t queue = getCurrentQueue();
+
+            if (queue == NoQueue || !_queues[queue]->push(task))
+            {
+                std::lock_guard<std::mutex> lock(_injectedMutex);
+                _injected.push_back(task);
+                _injectedCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // a worker going to sleep either sees _queued or gets notified
+            if (_sleeping.load() > 0)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_sleepMutex);
+                }
+
+                _sleepCondition.notify_one();
+            }
+        }
+
+        void JobSystem::finish(Counter* counter)
+        {
+            if (counter == nullptr)
+            {
+                return;
+            }
+
+            std::vector<Counter::Continuation> continuations;
+
+            {
+                std::lock_guard<std::mutex> lock(counter->_mutex);
+
+                if (counter->_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    continuations.swap(counter->_continuations);
+                }
+            }
+
+            for (Counter::Continuation& continuation : continuations)
+            {
+                schedule(createTask(std::move(continuation.job), continuation.counter), continuation.affinity);
+            }
+        }
+
+        void JobSystem::execute(Task* task)
+        {
+            task->job();
+            finish(task->counter);
+
+            releaseTask(task);
+        }
+
+        void JobSystem::workerLoop(size_t queue)
+        {
+            currentSystem = this;
+            currentQueue = queue;
+
+            int idle = 0;
+
+            while (true)
+            {
+                if (Task* task = findTask(queue))
+                {
+                    execute(task);
+                    idle = 0;
+                    continue;
+                }
+
+                // new jobs usually arrive soon after the last ones (next parallelFor, next frame)
+                if (++idle < SpinCount)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                idle = 0;
+
+                std::unique_lock<std::mutex> lock(_sleepMutex);
+                _sleeping.fetch_add(1);
+                _sleepCondition.wait(lock, [this]() { return _stopping || _queued.load() > 0; });
+                _sleeping.fetch_sub(1);
+
+                // stopping, but only once the deques are drained
+                if (_stopping && _queued.load() == 0)
+                {
+                    return;
+                }
+            }
+        }
+
+        size_t JobSystem::getCurrentQueue() const noexcept
+        {
+            return currentSystem == this ? currentQueue : NoQueue;
+        }
+
+        JobSystem::Task* JobSystem::findTask(size_t queue)
+        {
+            Task* task = queue != NoQueue ? _queues[queue]->pop() : nullptr;
+
+            // the lock is only taken when there may be something to take
+            if (task == nullptr && _injectedCount.load(std::memory_order_relaxed) > 0)
+            {
+                std::lock_guard<std::mutex> lock(_injectedMutex);
+
+                if (!_injected.empty())
+                {
+                    task = _injected.front();
+                    _injected.pop_front();
+                    _injectedCount.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+
+            // the victims after our own deque, so the thieves don't all start with the same one
+            for (size_t i = 1; task == nullptr && i <= _queues.size(); ++i)
+            {
+                const size_t victim = (queue == NoQueue ? i : queue + i) % _queues.size();
+
+                if (victim != queue)
+                {
+                    task = _queues[victim]->steal();
+                }
+            }
+
+            if (task != nullptr)
+            {
+                _queued.fetch_sub(1);
+            }
+
+            return task;
+        }
+    }
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Engine/Jobs/WorkStealingDeque.hpp>
+
+namespace isc
+{
+    namespace jobs
+    {
+        using Job = std::function<void()>;
+
+        enum class Affinity
+        {
+            Any,            // the deque of the calling thread, stolen by idle threads
+            MainThread,     // GL calls: only executed by executeMainThreadJobs() or wait() on the main thread
+        };
+
+        // Jobs still pending, JobSystem::wait() returns once it reaches zero.
+        // Jobs scheduled with runAfter() start when it reaches zero.
+        class Counter
+        {
+        public:
+
+            bool isDone() const noexcept;
+
+        private:
+
+            friend class JobSystem;
+
+            struct Continuation
+            {
+                Job job;
+                Counter* counter;
+                Affinity affinity;
+            };
+
+            std::atomic<uint32_t> _pending{ 0 };
+            std::mutex _mutex;
+            std::vector<Continuation> _continuations;
+        };
+
+        // Work stealing scheduler: every thread pushes and pops its jobs at the bottom of its own
+        // Chase-Lev deque, idle threads steal from the top of the others. std::thread natively, web workers
+        // on wasm-mt (-s USE_PTHREADS=1, taken from the PTHREAD_POOL_SIZE pool). Single threaded builds have
+        // no workers, the jobs run inside wait() or executeMainThreadJobs() on the calling thread.
+        //
+        // The GL context belongs to the main thread: jobs with Affinity::MainThread (or runOnMainThread())
+        // go to their own lane, executed once per frame with executeMainThreadJobs().
+        // Jobs must not throw, an exception escaping a worker terminates the program.
+        //
+        // Tasks are pooled: once the pool covers the peak, scheduling doesn't allocate as long as the job
+        // fits in std::function (2 pointers of captures with libstdc++, or a std::ref to a longer lived lambda).
+        class JobSystem
+        {
+        public:
+
+            // one worker per core, minus the main thread (the one constructing the JobSystem)
+            static constexpr size_t AutoWorkerCount = ~size_t(0);
+
+            // 0: every job runs on the threads calling wait()
+            explicit JobSystem(size_t workerCount = AutoWorkerCount);
+            ~JobSystem();
+
+            JobSystem(const JobSystem&) = delete;
+            JobSystem& operator=(const JobSystem&) = delete;
+
+            void run(Job job, Counter& counter, Affinity affinity = Affinity::Any);
+
+            // fence: the job starts once the dependency is done
+            void runAfter(Counter& dependency, Job job, Counter& counter, Affinity affinity = Affinity::Any);
+
+            // executes jobs on the calling thread until the counter is done,
+            // the main thread also runs its own lane so workers can't wait on it forever
+            void wait(Counter& counter);
+
+            // function(begin, end) over sub ranges of [begin, end), on the calling thread and the workers.
+            // The range is split in halves until they're not bigger than grain, 0 picks it from the thread count.
+            template<typename TFunction>
+            void parallelFor(size_t begin, size_t end, const TFunction& function, size_t grain = 0)
+            {
+                if (begin >= end)
+                {
+                    return;
+                }
+
+                Counter counter;
+                split(begin, end, grain > 0 ? grain : getGrainSize(end - begin), function, counter);
+                wait(counter);
+            }
+
+            // about 8 ranges per thread: small enough to balance uneven work, big enough to hide the scheduling
+            size_t getGrainSize(size_t count) const noexcept;
+
+            void runOnMainThread(Job job);
+
+            // without workers it also runs the other pending jobs, returns how many jobs were executed
+            size_t executeMainThreadJobs();
+
+            size_t getWorkerCount() const noexcept;
+            bool isMainThread() const noexcept;
+
+        private:
+
+            struct Task
+            {
+                Job job;
+                Counter* counter = nullptr;
+            };
+
+            using Queue = WorkStealingDeque<Task>;
+
+            static constexpr size_t NoQueue = ~size_t(0);
+            static constexpr int SpinCount = 64;
+
+            // [0] belongs to the main thread, [i + 1] to the worker i
+            std::vector<std::unique_ptr<Queue>> _queues;
+            std::vector<std::thread> _workers;
+            std::thread::id _mainThread;
+
+            // other threads, and full deques
+            std::deque<Task*> _injected;
+            std::atomic<size_t> _injectedCount{ 0 };
+            std::mutex _injectedMutex;
+
+            std::vector<Task*> _mainThreadTasks;
+            std::vector<Task*> _mainThreadBatch;   // swapped with _mainThreadTasks, keeps its capacity
+            std::mutex _mainThreadMutex;
+
+            // executed tasks, reused by the next jobs
+            std::vector<Task*> _freeTasks;
+            std::mutex _freeTasksMutex;
+
+            // jobs in the deques, the sleeping workers wait for it to be positive
+            std::atomic<int64_t> _queued{ 0 };
+            std::atomic<uint32_t> _sleeping{ 0 };
+            std::mutex _sleepMutex;
+            std::condition_variable _sleepCondition;
+            bool _stopping = false;
+
+            template<typename TFunction>
+            void split(size_t begin, size_t end, size_t grain, const TFunction& function, Counter& counter)
+            {
+                // the upper halves go to the deque, thieves take the biggest one first
+                while (end - begin > grain)
+                {
+                    const size_t middle = begin + (end - begin) / 2;
+
+                    run([this, middle, end, grain, &function, &counter]()
+                    {
+                        split(middle, end, grain, function, counter);
+                    }, counter);
+
+                    end = middle;
+                }
+
+                function(begin, end);
+            }
+
+            Task* createTask(Job job, Counter* counter);
+            void releaseTask(Task* task);
+            void schedule(Task* task, Affinity affinity);
+            void finish(Counter* counter);
+            void execute(Task* task);
+            void workerLoop(size_t queue);
+            size_t getCurrentQueue() const noexcept;
+            Task* findTask(size_t queue);
+        };
+    }
+}
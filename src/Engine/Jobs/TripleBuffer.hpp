@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace isc
+{
+    namespace jobs
+    {
+        // One writer thread and one reader thread exchanging whole states without locks:
+        // the writer fills its own buffer and publishes it, the reader acquires the latest published one.
+        // Each side owns a buffer the other never touches, the third one is the handoff.
+        template<typename T>
+        class TripleBuffer
+        {
+        public:
+
+            // writer only
+            T& getWriteBuffer() noexcept
+            {
+                return _buffers[_write];
+            }
+
+            // writer only: the write buffer becomes the latest, and the writer takes the handoff one
+            void publish() noexcept
+            {
+                const uint8_t previous = _handoff.exchange(static_cast<uint8_t>(_write | Fresh), std::memory_order_acq_rel);
+                _write = previous & IndexMask;
+            }
+
+            // reader only: the latest published buffer, nullptr before the first publish().
+            // Stays valid and unchanged until the next acquire().
+            const T* acquire() noexcept
+            {
+                if ((_handoff.load(std::memory_order_relaxed) & Fresh) != 0)
+                {
+                    const uint8_t previous = _handoff.exchange(_read, std::memory_order_acq_rel);
+                    _read = previous & IndexMask;
+                    _hasRead = true;
+                }
+
+                return _hasRead ? &_buffers[_read] : nullptr;
+            }
+
+        private:
+
+            static constexpr uint8_t IndexMask = 0x3;
+            static constexpr uint8_t Fresh = 0x4;
+
+            std::array<T, 3> _buffers;
+            uint8_t _write = 0;
+            std::atomic<uint8_t> _handoff{ 1 };
+            uint8_t _read = 2;
+            bool _hasRead = false;
+        };
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace isc
+{
+    namespace jobs
+    {
+        // Chase-Lev deque with a fixed capacity (C11 memory orders from Lê et al. 2013).
+        // Only the owner thread calls push() and pop(), at the bottom (LIFO, the data is still in cache),
+        // any other thread can steal() from the top (FIFO, the oldest and usually biggest jobs).
+        template<typename T>
+        class WorkStealingDeque
+        {
+        public:
+
+            // capacity: power of two
+            explicit WorkStealingDeque(size_t capacity = 4096)
+                : _mask(static_cast<int64_t>(capacity) - 1)
+                , _buffer(new std::atomic<T*>[capacity])
+            {
+            }
+
+            WorkStealingDeque(const WorkStealingDeque&) = delete;
+            WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+            // owner only, false when full
+            bool push(T* item) noexcept
+            {
+                const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+                const int64_t top = _top.load(std::memory_order_acquire);
+
+                if (bottom - top > _mask)
+                {
+                    return false;
+                }
+
+                _buffer[bottom & _mask].store(item, std::memory_order_relaxed);
+                _bottom.store(bottom + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            // owner only
+            T* pop() noexcept
+            {
+                const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+                _bottom.store(bottom, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t top = _top.load(std::memory_order_relaxed);
+
+                if (top > bottom)
+                {
+                    // empty
+                    _bottom.store(bottom + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                T* item = _buffer[bottom & _mask].load(std::memory_order_relaxed);
+
+                if (top == bottom)
+                {
+                    // last item: race against the thieves
+                    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    {
+                        item = nullptr;
+                    }
+
+                    _bottom.store(bottom + 1, std::memory_order_relaxed);
+                }
+
+                return item;
+            }
+
+            // any thread, nullptr when empty or when another thread won the item
+            T* steal() noexcept
+            {
+                int64_t top = _top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const int64_t bottom = _bottom.load(std::memory_order_acquire);
+
+                if (top >= bottom)
+                {
+                    return nullptr;
+                }
+
+                T* item = _buffer[top & _mask].load(std::memory_order_relaxed);
+
+                if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    return nullptr;
+                }
+
+                return item;
+            }
+
+        private:
+
+            static constexpr size_t CacheLine = 64;
+
+            // top and bottom on their own cache lines: thieves and owner don't invalidate each other
+            std::atomic<int64_t> _top{ 0 };
+            char _topPadding[CacheLine - sizeof(std::atomic<int64_t>)];
+            std::atomic<int64_t> _bottom{ 0 };
+            char _bottomPadding[CacheLine - sizeof(std::atomic<int64_t>)];
+
+            const int64_t _mask;
+            std::unique_ptr<std::atomic<T*>[]> _buffer;
+        };
+    }
+}
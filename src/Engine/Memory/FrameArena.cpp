@@ -0,0 +1,215 @@
+#include "FrameArena.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#if defined(__SANITIZE_ADDRESS__)
+    #include <sanitizer/asan_interface.h>
+    #define ISC_ARENA_POISON(address, size) ASAN_POISON_MEMORY_REGION(address, size)
+    #define ISC_ARENA_UNPOISON(address, size) ASAN_UNPOISON_MEMORY_REGION(address, size)
+#else
+    #define ISC_ARENA_POISON(address, size) do {} while (false)
+    #define ISC_ARENA_UNPOISON(address, size) do {} while (false)
+#endif
+
+namespace isc
+{
+    constexpr size_t FrameArena::DefaultCapacity;
+
+    namespace
+    {
+        std::atomic<uint64_t> currentFrame{ 0 };
+
+        // arenas live until the end of the program, threads may finish before the report
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<FrameArena>> arenas;
+        };
+
+        Registry& getRegistry()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        FrameArena* registerArena()
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+
+            registry.arenas.push_back(std::make_unique<FrameArena>());
+
+            return registry.arenas.back().get();
+        }
+
+        size_t alignUp(size_t value, size_t alignment) noexcept
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    void FrameArena::beginFrame() noexcept
+    {
+        currentFrame.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    FrameArena& FrameArena::get()
+    {
+        thread_local FrameArena* arena = registerArena();
+        return *arena;
+    }
+
+    void FrameArena::report(std::ostream& output)
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        for (size_t i = 0; i < registry.arenas.size(); ++i)
+        {
+            const FrameArena& arena = *registry.arenas[i];
+
+            output << "[FrameArena] thread " << i
+                << ": high water " << arena.getHighWaterMark()
+                << " / " << arena.getCapacity() << " bytes, "
+                << arena.getHeapFallbacks() << " heap fallbacks" << std::endl;
+        }
+    }
+
+    FrameArena::FrameArena(size_t capacity)
+        : _frame(currentFrame.load(std::memory_order_relaxed))
+        , _capacity(std::max<size_t>(capacity, 64))
+    {
+    }
+
+    FrameArena::~FrameArena()
+    {
+        reset();
+
+        if (_buffer)
+        {
+            ISC_ARENA_UNPOISON(_buffer.get(), _capacity.load(std::memory_order_relaxed));
+        }
+    }
+
+    void* FrameArena::allocate(size_t bytes, size_t alignment)
+    {
+        const uint64_t frame = currentFrame.load(std::memory_order_relaxed);
+
+        if (_frame != frame)
+        {
+            reset();
+            _frame = frame;
+        }
+
+        const size_t capacity = _capacity.load(std::memory_order_relaxed);
+
+        if (!_buffer)
+        {
+            _buffer.reset(new uint8_t[capacity]);
+            ISC_ARENA_POISON(_buffer.get(), capacity);
+        }
+
+        const size_t begin = alignUp(_offset, alignment);
+
+        if (begin + bytes > capacity)
+        {
+            // room to align the block, malloc only guarantees alignof(std::max_align_t)
+            void* block = std::malloc(bytes + alignment);
+
+            if (block == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+
+            _heapBlocks.push_back(block);
+            _heapBytes += bytes;
+            _heapFallbacks.fetch_add(1, std::memory_order_relaxed);
+
+            _highWaterMark.store(std::max(_highWaterMark.load(std::memory_order_relaxed), _offset + _heapBytes), std::memory_order_relaxed);
+
+            return reinterpret_cast<void*>(alignUp(reinterpret_cast<uintptr_t>(block), alignment));
+        }
+
+        _offset = begin + bytes;
+        _highWaterMark.store(std::max(_highWaterMark.load(std::memory_order_relaxed), _offset + _heapBytes), std::memory_order_relaxed);
+
+        ISC_ARENA_UNPOISON(_buffer.get() + begin, bytes);
+
+        return _buffer.get() + begin;
+    }
+
+    void FrameArena::deallocate(void* pointer, size_t bytes) noexcept
+    {
+        uint8_t* address = static_cast<uint8_t*>(pointer);
+
+        if (_buffer && address + bytes == _buffer.get() + _offset)
+        {
+            _offset -= bytes;
+            ISC_ARENA_POISON(address, bytes);
+        }
+    }
+
+    void FrameArena::reset() noexcept
+    {
+        for (void* block : _heapBlocks)
+        {
+            std::free(block);
+        }
+
+        _heapBlocks.clear();
+        _heapBytes = 0;
+
+        if (!_buffer)
+        {
+            return;
+        }
+
+#ifdef DEBUG
+        // reads of stale frame data show up as 0xDDDDDDDD
+        ISC_ARENA_UNPOISON(_buffer.get(), _offset);
+        std::memset(_buffer.get(), 0xDD, _offset);
+#endif
+
+        ISC_ARENA_POISON(_buffer.get(), _offset);
+        _offset = 0;
+
+        // grown to the high-water mark: the next frames don't need the heap anymore
+        const size_t highWaterMark = _highWaterMark.load(std::memory_order_relaxed);
+        size_t capacity = _capacity.load(std::memory_order_relaxed);
+
+        if (highWaterMark > capacity)
+        {
+            while (capacity < highWaterMark)
+            {
+                capacity *= 2;
+            }
+
+            ISC_ARENA_UNPOISON(_buffer.get(), _capacity.load(std::memory_order_relaxed));
+            _buffer.reset();
+            _capacity.store(capacity, std::memory_order_relaxed);
+        }
+    }
+
+    size_t FrameArena::getUsed() const noexcept
+    {
+        return _offset + _heapBytes;
+    }
+
+    size_t FrameArena::getCapacity() const noexcept
+    {
+        return _capacity.load(std::memory_order_relaxed);
+    }
+
+    size_t FrameArena::getHighWaterMark() const noexcept
+    {
+        return _highWaterMark.load(std::memory_order_relaxed);
+    }
+
+    uint64_t FrameArena::getHeapFallbacks() const noexcept
+    {
+        return _heapFallbacks.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace isc
+{
+    // Bump allocator for the data that only lives during one frame, one per thread:
+    //
+    //     FrameVector<SDL_Event> events;                  // the arena of the calling thread
+    //
+    // Every arena rewinds itself on its first allocation after FrameArena::beginFrame(), so nothing
+    // allocated from it can be kept across frames (jobs running longer than a frame use the heap).
+    // Allocations that don't fit go to the heap and grow the arena at the next frame: once the
+    // high-water mark is reached no frame calls malloc. Debug builds (-DDEBUG) fill rewound memory
+    // with 0xDD, AddressSanitizer builds also poison it.
+    class FrameArena
+    {
+    public:
+
+        static constexpr size_t DefaultCapacity = 256 * 1024;
+
+        // starts a new frame for every thread arena, called by the game loops
+        static void beginFrame() noexcept;
+
+        // arena of the calling thread, kept until the end of the program
+        static FrameArena& get();
+
+        // capacity, high-water mark and heap fallbacks of every thread arena
+        static void report(std::ostream& output);
+
+        // the memory is only reserved on the first allocation
+        explicit FrameArena(size_t capacity = DefaultCapacity);
+        ~FrameArena();
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+        // only the last allocation is given back (vectors growing in place), the rest waits for the next frame
+        void deallocate(void* pointer, size_t bytes) noexcept;
+
+        // releases everything at once, called automatically at the next frame
+        void reset() noexcept;
+
+        size_t getUsed() const noexcept;
+        size_t getCapacity() const noexcept;
+
+        // the most bytes a single frame needed, heap fallbacks included
+        size_t getHighWaterMark() const noexcept;
+
+        // allocations that didn't fit in the arena since it was created
+        uint64_t getHeapFallbacks() const noexcept;
+
+    private:
+
+        std::unique_ptr<uint8_t[]> _buffer;
+        size_t _offset = 0;
+        uint64_t _frame = 0;
+
+        // fallbacks of the current frame, freed on reset
+        std::vector<void*> _heapBlocks;
+        size_t _heapBytes = 0;
+
+        // read by report() from other threads
+        std::atomic<size_t> _capacity;
+        std::atomic<size_t> _highWaterMark{ 0 };
+        std::atomic<uint64_t> _heapFallbacks{ 0 };
+    };
+
+    // STL allocator on a FrameArena, the one of the constructing thread by default
+    template<typename T>
+    class FrameAllocator
+    {
+    public:
+
+        using value_type = T;
+
+        FrameAllocator()
+            : _arena(&FrameArena::get())
+        {
+        }
+
+        explicit FrameAllocator(FrameArena& arena) noexcept
+            : _arena(&arena)
+        {
+        }
+
+        template<typename U>
+        FrameAllocator(const FrameAllocator<U>& other) noexcept
+            : _arena(other.getArena())
+        {
+        }
+
+        T* allocate(size_t count)
+        {
+            if (count > static_cast<size_t>(-1) / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+
+            return static_cast<T*>(_arena->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* pointer, size_t count) noexcept
+        {
+            _arena->deallocate(pointer, count * sizeof(T));
+        }
+
+        FrameArena* getArena() const noexcept
+        {
+            return _arena;
+        }
+
+    private:
+
+        FrameArena* _arena;
+    };
+
+    template<typename T, typename U>
+    bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b) noexcept
+    {
+        return a.getArena() == b.getArena();
+    }
+
+    template<typename T, typename U>
+    bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b) noexcept
+    {
+        return !(a == b);
+    }
+
+    template<typename T>
+    using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+    template<typename T>
+    using FrameDeque = std::deque<T, FrameAllocator<T>>;
+
+    using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <SDL.h>
+
+namespace isc
+{
+    namespace sdl
+    {
+        // Bounding rect of everything touched since the last reset
+        class DirtyRegion
+        {
+        public:
+
+            void add(const SDL_Rect& rect)
+            {
+                SDL_UnionRect(&_bounds, &rect, &_bounds);
+            }
+
+            void reset()
+            {
+                _bounds = { 0, 0, 0, 0 };
+            }
+
+            bool isEmpty() const
+            {
+                return SDL_RectEmpty(&_bounds) == SDL_TRUE;
+            }
+
+            const SDL_Rect& getBounds() const
+            {
+                return _bounds;
+            }
+
+            static SDL_Rect merge(const DirtyRegion& a, const DirtyRegion& b)
+            {
+                SDL_Rect result;
+                SDL_UnionRect(&a._bounds, &b._bounds, &result);
+
+                return result;
+            }
+
+        private:
+
+            SDL_Rect _bounds = { 0, 0, 0, 0 };
+        };
+    }
+}
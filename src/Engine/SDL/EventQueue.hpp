@@ -1,9 +1,9 @@
 #pragma once
 
-#include <deque>
 #include <SDL.h>
 
 #include <Engine/Extensions/Callable.hpp>
+#include <Engine/Memory/FrameArena.hpp>
 
 namespace isc
 {
@@ -27,7 +27,10 @@ namespace isc
             {
                 bool result = false;
 
-                std::deque<SDL_Event> events;
+                // frame memory: no heap allocation for the events put back
+                FrameVector<SDL_Event> events;
+                events.reserve(64);
+
                 SDL_Event currentEvent;
 
                 while (poll(currentEvent))
@@ -0,0 +1,99 @@
+#include "Renderer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace isc
+{
+    namespace sdl
+    {
+        Renderer::Renderer()
+            : _surface()
+            , _renderer(sdl::makeNullObject<SDL_Renderer>())
+        {
+        }
+
+        void Renderer::create(const vec2<uint32_t>& size)
+        {
+            // release the old renderer before its surface
+            _renderer.reset();
+
+            _surface.create(size);
+            _renderer = sdl::makeObject<SDL_Renderer>(SDL_CreateSoftwareRenderer, SDL_DestroyRenderer, _surface.get());
+
+            // new surface: everything has to be uploaded once
+            _previous.reset();
+            _current.reset();
+            _current.add({ 0, 0, static_cast<int>(size.x), static_cast<int>(size.y) });
+        }
+
+        void Renderer::beginFrame()
+        {
+            _previous = _current;
+            _current.reset();
+
+            if (!_previous.isEmpty())
+            {
+                SDL_Surface* surface = _surface.get();
+                SDL_FillRect(surface, &_previous.getBounds(), SDL_MapRGBA(surface->format, 0, 0, 0, 0));
+            }
+        }
+
+        void Renderer::setDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+        {
+            SDL_SetRenderDrawColor(_renderer.get(), r, g, b, a);
+        }
+
+        void Renderer::drawPoint(int32_t x, int32_t y)
+        {
+            SDL_RenderDrawPoint(_renderer.get(), x, y);
+            markDirty({ x, y, 1, 1 });
+        }
+
+        void Renderer::drawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+        {
+            SDL_RenderDrawLine(_renderer.get(), x1, y1, x2, y2);
+            markDirty({
+                std::min(x1, x2), std::min(y1, y2),
+                std::abs(x2 - x1) + 1, std::abs(y2 - y1) + 1 });
+        }
+
+        void Renderer::drawRect(const SDL_Rect& rect)
+        {
+            SDL_RenderDrawRect(_renderer.get(), &rect);
+            markDirty(rect);
+        }
+
+        void Renderer::fillRect(const SDL_Rect& rect)
+        {
+            SDL_RenderFillRect(_renderer.get(), &rect);
+            markDirty(rect);
+        }
+
+        SDL_Rect Renderer::getUploadRegion() const
+        {
+            return DirtyRegion::merge(_previous, _current);
+        }
+
+        SDL_Renderer* Renderer::get() const noexcept
+        {
+            return _renderer.get();
+        }
+
+        const Surface& Renderer::getSurface() const noexcept
+        {
+            return _surface;
+        }
+
+        void Renderer::markDirty(SDL_Rect rect)
+        {
+            const SDL_Surface* surface = _surface.get();
+            const SDL_Rect bounds = { 0, 0, surface->w, surface->h };
+
+            if (SDL_IntersectRect(&rect, &bounds, &rect) == SDL_TRUE)
+            {
+                _current.add(rect);
+            }
+        }
+    }
+}
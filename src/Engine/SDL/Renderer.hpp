@@ -2,22 +2,49 @@
 
 #include <Engine/SDL/Object.hpp>
 #include <Engine/SDL/Surface.hpp>
+#include <Engine/SDL/DirtyRegion.hpp>
+#include <Engine/Math/Vector.hpp>
 #include <SDL.h>
 
 namespace isc
 {
     namespace sdl
     {
+        // Software renderer drawing into a Surface.
+        // Keeps track of the pixels touched by every draw call, so only the
+        // modified area needs to be cleared and uploaded each frame.
         class Renderer
         {
         public:
 
             Renderer();
+            void create(const vec2<uint32_t>& size);
+
+            // clears whatever was drawn during the previous frame
+            void beginFrame();
+
+            void setDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+            void drawPoint(int32_t x, int32_t y);
+            void drawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+            void drawRect(const SDL_Rect& rect);
+            void fillRect(const SDL_Rect& rect);
+
+            // area that changed since the last frame (previous + current draws)
+            SDL_Rect getUploadRegion() const;
+
+            SDL_Renderer* get() const noexcept;
+            const Surface& getSurface() const noexcept;
 
         private:
 
-            sdl::Object<SDL_Renderer> _renderer;
+            // declared before the renderer: it must outlive it
             Surface _surface;
+            sdl::Object<SDL_Renderer> _renderer;
+
+            DirtyRegion _previous;
+            DirtyRegion _current;
+
+            void markDirty(SDL_Rect rect);
         };
     }
 }
@@ -35,5 +35,10 @@ namespace isc
             : _surface(sdl::makeObject<SDL_Surface>(rawSurface, SDL_FreeSurface))
         {
         }
+
+        SDL_Surface* Surface::get() const noexcept
+        {
+            return _surface.get();
+        }
     }
 }
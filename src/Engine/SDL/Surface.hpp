@@ -17,6 +17,8 @@ namespace isc
             Surface();
             void create(const vec2<uint32_t>& size);
 
+            SDL_Surface* get() const noexcept;
+
         private:
 
             sdl::Object<SDL_Surface> _surface;
@@ -1,6 +1,9 @@
+#include <cmath>
 #include <iostream>
 #include <exception>
 #include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 
 #ifdef __EMSCRIPTEN__
@@ -11,311 +14,396 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <Engine/Debug/UpdateProfiler.hpp>
+#include <Engine/Debug/ProfileZone.hpp>
 
+#include <Engine/Exceptions/RuntimeException.hpp>
 #include <Engine/Extensions/Optional.hpp>
 #include <Engine/GameLoop.hpp>
 #include <Engine/IO/Window.hpp>
+#include <Engine/IO/HeadlessWindow.hpp>
 #include <Engine/IO/ResourceProvider.hpp>
+#include <Engine/Jobs/JobSystem.hpp>
+#include <Engine/Memory/FrameArena.hpp>
 #include <Engine/SDL/EventQueue.hpp>
+#include <Engine/SDL/Renderer.hpp>
 
+#include <Engine/Graphics/Camera.hpp>
+#include <Engine/Graphics/TransformBatch.hpp>
+#include <Engine/Graphics/TransformHierarchy.hpp>
 #include <Engine/Graphics/OpenGL/OpenGL.hpp>
+#include <Engine/Graphics/OpenGL/StreamingTexture.hpp>
+#include <Engine/Graphics/OpenGL/GeometryArena.hpp>
+#include <Engine/Graphics/OpenGL/GpuProfiler.hpp>
+#include <Engine/Graphics/OpenGL/MeshBuilder.hpp>
+#include <Engine/Graphics/OpenGL/ProgramCache.hpp>
+#include <Engine/Graphics/OpenGL/ShaderLibrary.hpp>
+#include <Engine/Graphics/OpenGL/ShaderProgram.hpp>
+#include <Engine/Graphics/OpenGL/StateCache.hpp>
+#include <Engine/Graphics/OpenGL/RenderQueue.hpp>
+#include <Engine/Graphics/OpenGL/SpriteBatch.hpp>
+#include <Engine/Graphics/OpenGL/TextureAtlas.hpp>
+#include <Engine/Graphics/OpenGL/UniformBuffer.hpp>
 
 struct renderable
 {
-    GLuint program = 0;
-    GLuint vao = 0, vbo = 0, index = 0;
-    GLsizei count = 0;
-
-    void render(bool wireframe = false) const
+    isc::gl::ShaderLibrary::ShaderId shader = 0;
+    isc::gl::ShaderLibrary::Variant variant = 0;
+    isc::gl::MeshHandle mesh;
+    glm::mat4 dequantization = glm::mat4(1.f);
+    isc::TransformHierarchy::Node transform = isc::TransformHierarchy::NoParent;
+
+    // the first draw waits for the program to finish linking
+    isc::gl::DrawCommand draw(const isc::gl::GeometryArena& geometry, isc::gl::ShaderLibrary& shaders, bool wireframe = false)
     {
-        GLenum mode = wireframe ? GL_LINE_LOOP : GL_TRIANGLES;
-        GLsizei verticesCount = 3 * count;
-
-        GL(glUseProgram(program));
-        GL(glBindVertexArray(vao));
-
-        if (index == 0)
-        {
-            GL(glBindBuffer(GL_ARRAY_BUFFER, vbo));
-            GL(glDrawArrays(mode, 0, verticesCount));
-            GL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-        }
-        else
-        {
-            GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index));
-            GL(glDrawElements(mode, verticesCount, GL_UNSIGNED_INT, nullptr));
-            GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-        }
-
-        GL(glBindVertexArray(0));
-        GL(glUseProgram(0));
+        return geometry.makeCommand(mesh, &shaders.get(shader, variant), wireframe ? GL_LINE_LOOP : GL_TRIANGLES);
     }
 };
 
-template<typename CRender>
-void usingSurfaceTexture(const SDL_Surface* surface, const CRender& render)
+// every mesh shares the same arena: positions only, as normalized shorts
+isc::gl::VertexLayout getPositionLayout()
 {
-    GLuint TextureID = 0;
-    GL(glGenTextures(1, &TextureID));
-    GL(glBindTexture(GL_TEXTURE_2D, TextureID));
+    return isc::gl::MeshBuilder().getLayout();
+}
 
-    int Mode = surface->format->BytesPerPixel == 4
-        ? GL_RGBA
-        : GL_RGB;
+void addMesh(isc::gl::GeometryArena& geometry, isc::gl::StateCache& state, const char* name, const isc::gl::MeshBuilder& builder, renderable& target)
+{
+    const isc::gl::MeshData mesh = builder.build();
 
-    GL(glTexImage2D(GL_TEXTURE_2D, 0, Mode, surface->w, surface->h, 0, Mode, GL_UNSIGNED_BYTE, surface->pixels));
+    target.mesh = geometry.add(state, mesh);
+    target.dequantization = mesh.getDequantization();
 
-    GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-    GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    // what the GPU stores: the arena has a single index type
+    const size_t bytes = geometry.getBytes(target.mesh);
 
-    GL(glActiveTexture(GL_TEXTURE0 + 0));
-    GL(glBindTexture(GL_TEXTURE_2D, TextureID));
+    std::cout << "[Mesh] " << name << ": " << bytes << " bytes ("
+        << (mesh.floatBytes > bytes ? mesh.floatBytes - bytes : 0) << " saved over floats)" << std::endl;
+}
 
-    render();
+template<typename CRender>
+size_t usingSurfaceTexture(isc::gl::StateCache& state, isc::gl::StreamingTexture& texture, const isc::sdl::Renderer& renderer, const CRender& render)
+{
+    ISC_PROFILE_SCOPE("render.overlay");
 
-    GL(glBindTexture(GL_TEXTURE_2D, 0));
+    // only the area modified during this and the previous frame changed
+    size_t uploadedBytes = texture.upload(renderer.getSurface().get(), renderer.getUploadRegion());
 
-    GL(glDeleteTextures(1, &TextureID));
-}
+    // the upload binds (and unbinds) the texture and pixel buffers by itself
+    state.invalidateTextures();
+    state.invalidateBuffers();
 
-inline void new2dLayer()
-{
-    GL(glClear(GL_DEPTH_BUFFER_BIT));
+    state.bindTexture(0, GL_TEXTURE_2D, texture.getId());
+
+    render();
+
+    return uploadedBytes;
 }
 
-renderable prepareFramebufferQuad()
+// every mesh of the demo is drawn by a variant of the same shader
+isc::gl::ShaderLibrary::ShaderId prepareShaders(isc::gl::ShaderLibrary& shaders)
 {
-    renderable quad;
-
-    // Create Vertex Array Object
-    glGenVertexArrays(1, &quad.vao);
-    glBindVertexArray(quad.vao);
+    shaders.addSource("precision.glsl", R"SHADER_END(
+        precision mediump float;
+    )SHADER_END");
 
-    // Create a Vertex Buffer Object and copy the vertex data to it
-    glGenBuffers(1, &quad.vbo);
+    shaders.addSource("blocks.glsl", R"SHADER_END(
+        layout(std140) uniform Camera
+        {
+            mat4 view;
+            mat4 projection;
+            mat4 viewProjection;
+            vec4 position;
+        } camera;
 
-    GLfloat vertices[] = {
-        -1.f, -1.f, 1.f, -1.f, -1.f, 1.f,
-        -1.f, 1.f, 1.f, -1.f, 1.f, 1.f
-    };
+        layout(std140) uniform Object
+        {
+            mat4 model;
+            vec4 color;
+        } object;
+    )SHADER_END");
 
-    glBindBuffer(GL_ARRAY_BUFFER, quad.vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    shaders.addSource("mesh.vsh", "#version 300 es\n" R"SHADER_END(
 
-    quad.count = 2;
+        layout(location = 0) in vec3 position;
 
-    const GLchar* vertexSource = "#version 300 es\n" R"SHADER_END(
+        #ifdef TEXTURED
+            out vec2 UV;
+        #endif
 
-        in vec2 position;
-        out vec2 UV;
+        #ifdef TRANSFORM
+            #include "blocks.glsl"
+        #endif
 
         void main()
         {
+        #ifdef TEXTURED
             UV = (position.xy + vec2(1, 1)) / 2.0;
             UV.y = -UV.y; // SDL software uses DirectX coordinate system
+        #endif
 
+        #ifdef TRANSFORM
+            gl_Position = camera.viewProjection * object.model * vec4(position, 1.0);
+        #else
             gl_Position = vec4(position.xy, 0.0, 1.0);
+        #endif
         }
 
-    )SHADER_END";
+    )SHADER_END");
 
-    const GLchar* fragmentSource = "#version 300 es\n" R"SHADER_END(
+    shaders.addSource("mesh.fsh", "#version 300 es\n" R"SHADER_END(
+
+        #include "precision.glsl"
 
-        precision mediump float;
         out vec4 color;
 
-        in vec2 UV;
-        uniform sampler2D diffuseTexture;
+        #ifdef TEXTURED
+            in vec2 UV;
+            uniform sampler2D diffuseTexture;
+        #endif
 
         void main()
         {
+        #if defined(TEXTURED)
             color = texture(diffuseTexture, UV);
+        #elif defined(WIREFRAME)
+            color = vec4(0.0, 0.0, 0.0, 1.0);
+        #else
+            color = vec4(0.4, 0.8, 0.2, 1.0);
+        #endif
         }
 
-    )SHADER_END";
-
-    quad.program = isc::gl::compileProgram(vertexSource, fragmentSource);
+    )SHADER_END");
 
-    glUseProgram(quad.program);
-
-    // Specify the layout of the vertex data
-    GLint posAttrib = glGetAttribLocation(quad.program, "position");
-    glEnableVertexAttribArray(posAttrib);
-    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 0, 0);
-
-    return quad;
+    return shaders.addShader("mesh.vsh", "mesh.fsh", { "TEXTURED", "TRANSFORM", "WIREFRAME" });
 }
 
-renderable prepareTriangle()
+renderable prepareFramebufferQuad(isc::gl::GeometryArena& geometry, isc::gl::StateCache& state, isc::gl::ShaderLibrary& shaders, isc::gl::ShaderLibrary::ShaderId meshShader)
 {
-    renderable triangle;
-
-    // Create Vertex Array Object
-    glGenVertexArrays(1, &triangle.vao);
-    glBindVertexArray(triangle.vao);
+    renderable quad;
 
-    // Create a Vertex Buffer Object and copy the vertex data to it
-    glGenBuffers(1, &triangle.vbo);
+    isc::gl::MeshBuilder builder;
 
-    GLfloat vertices[] = { 0.0f, 0.5f, -0.5f, -0.5f, 0.5f, -0.5f };
+    const auto bottomLeft = builder.addVertex({ -1.f, -1.f, 0.f });
+    const auto bottomRight = builder.addVertex({ 1.f, -1.f, 0.f });
+    const auto topLeft = builder.addVertex({ -1.f, 1.f, 0.f });
+    const auto topRight = builder.addVertex({ 1.f, 1.f, 0.f });
 
-    glBindBuffer(GL_ARRAY_BUFFER, triangle.vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    builder.addTriangle(bottomLeft, bottomRight, topLeft);
+    builder.addTriangle(topLeft, bottomRight, topRight);
 
-    triangle.count = 1;
+    addMesh(geometry, state, "framebuffer quad", builder, quad);
 
-    const GLchar* vertexSource = "#version 300 es\n" R"SHADER_END(
+    quad.shader = meshShader;
+    quad.variant = shaders.getFeature(meshShader, "TEXTURED");
+    shaders.request(quad.shader, quad.variant);
 
-        in vec2 position;
-        out vec4 color;
-
-        void main()
-        {
-            gl_Position = vec4(position.xy, 0.0, 1.0);
-        }
-
-    )SHADER_END";
-
-    const GLchar* fragmentSource = "#version 300 es\n" R"SHADER_END(
-
-        precision mediump float;
-        out vec4 color;
+    return quad;
+}
 
-        void main()
-        {
-            color = vec4(0.4, 0.8, 0.2, 1.0);
-        }
+renderable prepareTriangle(isc::gl::GeometryArena& geometry, isc::gl::StateCache& state, isc::gl::ShaderLibrary& shaders, isc::gl::ShaderLibrary::ShaderId meshShader)
+{
+    renderable triangle;
 
-    )SHADER_END";
+    isc::gl::MeshBuilder builder;
 
-    triangle.program = isc::gl::compileProgram(vertexSource, fragmentSource);
+    builder.addTriangle(
+        builder.addVertex({ 0.f, 0.5f, 0.f }),
+        builder.addVertex({ -0.5f, -0.5f, 0.f }),
+        builder.addVertex({ 0.5f, -0.5f, 0.f }));
 
-    glUseProgram(triangle.program);
+    addMesh(geometry, state, "triangle", builder, triangle);
 
-    // Specify the layout of the vertex data
-    GLint posAttrib = glGetAttribLocation(triangle.program, "position");
-    glEnableVertexAttribArray(posAttrib);
-    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    triangle.shader = meshShader;
+    triangle.variant = 0; // flat color, clip space positions
+    shaders.request(triangle.shader, triangle.variant);
 
     return triangle;
 }
 
-renderable prepareCube()
+renderable prepareCube(isc::gl::GeometryArena& geometry, isc::gl::StateCache& state, isc::gl::ShaderLibrary& shaders, isc::gl::ShaderLibrary::ShaderId meshShader)
 {
     renderable cube;
 
-    // VAO
-    glGenVertexArrays(1, &cube.vao);
-    glBindVertexArray(cube.vao);
-
-    // VBO
-    GLfloat vertices[] = {
-        0.f, 1.f, 0.f,
-        -1.f, 0.f, -1.f,
-        1.f, 0.f, -1.f,
-        0.f, 0.f, 1.f,
-    };
-
-    glGenBuffers(1, &cube.vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, cube.vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), &vertices[0], GL_STATIC_DRAW);
+    isc::gl::MeshBuilder builder;
 
-    // INDEX
-    GLuint indices[] = {
-        1, 0, 2,
-        2, 0, 3,
-        3, 0, 1,
-        2, 3, 1,
-    };
+    builder.addVertex({ 0.f, 1.f, 0.f });
+    builder.addVertex({ -1.f, 0.f, -1.f });
+    builder.addVertex({ 1.f, 0.f, -1.f });
+    builder.addVertex({ 0.f, 0.f, 1.f });
 
-    glGenBuffers(1, &cube.index);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cube.index);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), &indices[0], GL_STATIC_DRAW);
+    builder.addTriangle(1, 0, 2);
+    builder.addTriangle(2, 0, 3);
+    builder.addTriangle(3, 0, 1);
+    builder.addTriangle(2, 3, 1);
 
-    cube.count = 4;
+    addMesh(geometry, state, "cube", builder, cube);
 
-    const GLchar* vertexSource = "#version 300 es\n" R"SHADER_END(
+    cube.shader = meshShader;
+    cube.variant = shaders.getFeature(meshShader, "TRANSFORM") | shaders.getFeature(meshShader, "WIREFRAME");
+    shaders.request(cube.shader, cube.variant);
 
-        in vec3 position;
-        uniform mat4 MVP;
+    return cube;
+}
 
-        void main()
-        {
-            gl_Position = MVP * vec4(position, 1.0);
-        }
+enum AtlasImages : uint32_t
+{
+    BallImage,
+};
 
-    )SHADER_END";
+isc::sdl::Object<SDL_Surface> createBallImage(int size)
+{
+    auto image = isc::sdl::makeObject<SDL_Surface>(
+        SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_RGBA32),
+        SDL_FreeSurface);
 
-    const GLchar* fragmentSource = "#version 300 es\n" R"SHADER_END(
+    const float radius = size / 2.f;
 
-        precision mediump float;
-        out vec4 color;
+    for (int y = 0; y < size; ++y)
+    {
+        auto* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(image->pixels) + y * image->pitch);
 
-        void main()
+        for (int x = 0; x < size; ++x)
         {
-            color = vec4(0.0, 0.0, 0.0, 1.0);
-        }
-
-    )SHADER_END";
-
-    cube.program = isc::gl::compileProgram(vertexSource, fragmentSource);
-
-    glUseProgram(cube.program);
+            // antialiased edge
+            const float distance = glm::length(glm::vec2(x + 0.5f, y + 0.5f) - radius);
+            const auto alpha = static_cast<uint8_t>(255.f * glm::clamp(radius - distance, 0.f, 1.f));
 
-    // Specify the layout of the vertex data
-    GLint posAttrib = glGetAttribLocation(cube.program, "position");
-    glEnableVertexAttribArray(posAttrib);
-    glVertexAttribPointer(posAttrib, 3, GL_FLOAT, GL_FALSE, sizeof(float), 0);
+            row[x] = SDL_MapRGBA(image->format, 255, 255, 255, alpha);
+        }
+    }
 
-    return cube;
+    return image;
 }
 
-std::tuple<SDL_Renderer*, SDL_Surface*> createSurfaceRenderer(const isc::vec2<uint32_t>& size)
+// what render() reads from the simulation, copied once per frame
+struct FrameSnapshot
 {
-    Uint32 rmask, gmask, bmask, amask;
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-    rmask = 0xff000000;
-    gmask = 0x00ff0000;
-    bmask = 0x0000ff00;
-    amask = 0x000000ff;
-#else
-    rmask = 0x000000ff;
-    gmask = 0x0000ff00;
-    bmask = 0x00ff0000;
-    amask = 0xff000000;
-#endif
-
-    SDL_Surface* surface = SDL_CreateRGBSurface(0, size.x, size.y, 32, rmask, gmask, bmask, amask);
-    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
-
-    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(surface);
+    double previousElapsedSeconds = 0.0; // before the last step, render() interpolates from there
+    double elapsedSeconds = 0.0;
+    isc::vec2<float> pointer;
+    uint64_t cameraVersion = 0;
+    isc::gl::CameraBlock camera;
+    glm::mat4 cube = glm::mat4(1.f);
+    std::vector<glm::mat4> field; // world matrices of the visible cubes
+};
 
-    return { renderer, surface };
-}
+// SDL_Quit() once the members declared after it are destroyed: the GL objects, then the context
+struct SdlShutdown
+{
+    ~SdlShutdown()
+    {
+        SDL_Quit();
+    }
+};
 
 struct GameLoop
 {
-    isc::Window window;
-    SDL_Renderer* renderer = nullptr;
-    SDL_Surface* surface = nullptr;
+    using Snapshot = FrameSnapshot;
+
+    isc::jobs::JobSystem& jobs;
+    SdlShutdown sdlShutdown;
+    std::unique_ptr<isc::Window> window;
+    isc::sdl::Renderer renderer;
     isc::UpdateProfiler profiler;
+    isc::gl::GpuProfiler gpuProfiler;
+    isc::gl::StateCache glState;
+    isc::gl::RenderQueue renderQueue;
+    isc::gl::ProgramCache programs;
+    isc::gl::ShaderLibrary shaders;
+    isc::gl::GeometryArena geometry;
+    isc::gl::UniformBuffer cameraBlock;
+    isc::gl::UniformRing objectBlocks;
+    isc::gl::SpriteBatch sprites;
+    isc::gl::TextureAtlas atlas;
     isc::ResourceProvider resourceProvider;
 
+    isc::Camera camera;
+    isc::TransformHierarchy transforms;
+    isc::TransformHierarchy::Node scene = isc::TransformHierarchy::NoParent;
+    isc::TransformBatch field;
+    std::vector<isc::TransformBatch::Index> visibleField;
+
     nonstd::optional<isc::vec2<float>> touchLocation;
+    isc::vec2<float> pointer;
+    double previousElapsedSeconds = 0.0;
+    double elapsedSeconds = 0.0;
+    uint64_t cameraVersion = 0;
+    uint64_t uploadedCameraVersion = ~uint64_t(0);
+
+    // serial loops: extracted and rendered right away
+    FrameSnapshot snapshot;
 
+    isc::gl::StreamingTexture overlay;
     renderable framebufferQuad;
     renderable triangle;
     renderable cube;
 
-    explicit GameLoop()
+    isc::jobs::Counter assetJobs;
+    isc::sdl::Object<SDL_Surface> ballImage{ nullptr, SDL_FreeSurface };
+
+    GameLoop(isc::jobs::JobSystem& jobSystem, std::unique_ptr<isc::Window> gameWindow)
+        : jobs(jobSystem)
+        , window(std::move(gameWindow))
+        , shaders(programs)
+        , geometry(getPositionLayout())
+        , cameraBlock(sizeof(isc::gl::CameraBlock))
+        , objectBlocks(sizeof(isc::gl::ObjectBlock))
     {
-        window.create("Pong", { 640, 480 });
+        window->create("Pong", { 640, 480 });
+
+        renderer.create(window->getSize());
+        overlay.resize(window->getSize());
+
+        geometry.init(glState);
 
-        std::tie(renderer, surface) = createSurfaceRenderer(window.getSize());
+        programs.init();
 
-        framebufferQuad = prepareFramebufferQuad();
-        triangle = prepareTriangle();
-        cube = prepareCube();
+        // bound once per program at link time, then shared through the binding points
+        cameraBlock.init(glState);
+        objectBlocks.init(glState);
+        shaders.addBlock("Camera", isc::gl::CameraBinding);
+        shaders.addBlock("Object", isc::gl::ObjectBinding);
+
+        // only the variants in use are compiled, in the background until their first draw
+        const auto meshShader = prepareShaders(shaders);
+
+        framebufferQuad = prepareFramebufferQuad(geometry, glState, shaders, meshShader);
+        triangle = prepareTriangle(geometry, glState, shaders, meshShader);
+        cube = prepareCube(geometry, glState, shaders, meshShader);
+
+        scene = transforms.create();
+        cube.transform = transforms.create(scene, cube.dequantization);
+
+        // a ring of small cubes around the scene, culled against the camera every frame
+        for (int i = 0; i < 48; ++i)
+        {
+            const float angle = glm::radians(7.5f * static_cast<float>(i));
+            const glm::mat4 local = glm::translate(glm::mat4(1.f), glm::vec3(6.f * std::cos(angle), 0.f, 6.f * std::sin(angle)))
+                * glm::scale(glm::mat4(1.f), glm::vec3(0.3f))
+                * cube.dequantization;
+
+            field.add(local, glm::vec3(0.f), 1.5f);
+        }
+
+        // the projection is only rebuilt on resize
+        camera.setViewportSize(window->getSize());
+
+        // the cube and the overlay are drawn on top of everything before them
+        renderQueue.setLayerClear(1, GL_DEPTH_BUFFER_BIT);
+        renderQueue.setLayerClear(2, GL_DEPTH_BUFFER_BIT);
+
+        sprites.init(glState);
+
+        // generated on a worker, inserted into the atlas by the main thread (owner of the GL context)
+        jobs.run([this]()
+        {
+            ballImage = createBallImage(32);
+
+            jobs.runOnMainThread([this]()
+            {
+                atlas.insert(glState, BallImage, ballImage.get());
+                ballImage.reset();
+            });
+        }, assetJobs);
 
         resourceProvider.add("./resources/shaders/test.vsh");
         resourceProvider.add("./resources/shaders/error.vsh");
@@ -325,24 +413,37 @@ struct GameLoop
     void init()
     {
         SDL_RendererInfo rendererInfo;
-        SDL_GetRendererInfo(renderer, &rendererInfo);
+        SDL_GetRendererInfo(renderer.get(), &rendererInfo);
 
         isc::gl::printContext();
         std::cout << "[2D Renderer] SDL2 " << rendererInfo.name << std::endl;
+        std::cout << "[Jobs] " << jobs.getWorkerCount() << " workers" << std::endl;
+
+        gpuProfiler.init();
     }
 
     ~GameLoop()
     {
-        SDL_FreeSurface(surface);
-        SDL_DestroyRenderer(renderer);
+        ISC_PROFILE_DUMP("trace.json");
 
-        SDL_Quit();
+        jobs.wait(assetJobs);
+
+        isc::FrameArena::report(std::cout);
 
         std::cout << "[GameLoop] End" << std::endl;
     }
 
-    bool update(DeltaTime deltaTime)
+    // serial loops: input and simulation on the main thread
+    bool update(DeltaTime step)
+    {
+        return input() && simulate(step);
+    }
+
+    // main thread: events, window
+    bool input()
     {
+        ISC_PROFILE_SCOPE("input");
+
         if (resourceProvider.complete)
         {
             std::cout << "ALL LOADED" << std::endl;
@@ -352,7 +453,8 @@ struct GameLoop
 
         while (isc::sdl::EventQueue::poll(event))
         {
-            window.handleEvent(event);
+            window->handleEvent(event);
+            camera.handleEvent(event);
 
             switch (event.type)
             {
@@ -370,7 +472,7 @@ struct GameLoop
 
                     if (event.key.keysym.sym == SDLK_f)
                     {
-                        window.toggleFullScreen(false);
+                        window->toggleFullScreen(false);
                     }
 
                     break;
@@ -389,13 +491,18 @@ struct GameLoop
                 {
                     const auto& windowEvent = event.window;
 
+                    // the window sets the viewport itself, behind the cache's back
+                    if (windowEvent.event == SDL_WINDOWEVENT_RESIZED || windowEvent.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                    {
+                        glState.invalidateViewport();
+                    }
+
                     if (windowEvent.event == SDL_WINDOWEVENT_SIZE_CHANGED)
                     {
-                        const auto& windowSize = window.getSize();
+                        const auto& windowSize = window->getSize();
 
-                        SDL_FreeSurface(surface);
-                        SDL_DestroyRenderer(renderer);
-                        std::tie(renderer, surface) = createSurfaceRenderer(windowSize);
+                        renderer.create(windowSize);
+                        overlay.resize(windowSize);
 
                         std::cout << "Resize: [" << windowSize.x << "," << windowSize.y << "]" << std::endl;
                     }
@@ -407,92 +514,279 @@ struct GameLoop
             }
         }
 
-        return window.isOpen();
+        isc::vec2<int32_t> mouse;
+        SDL_GetMouseState(&mouse.x, &mouse.y);
+
+        pointer = touchLocation.has_value()
+            ? touchLocation.value()
+            : (isc::vec2<float>(mouse) / isc::vec2<float>(window->getSize()));
+
+        return window->isOpen();
     }
 
-    void render(DeltaTime deltaTime)
+    // any thread: no GL, no window
+    bool simulate(DeltaTime step)
     {
+        ISC_PROFILE_SCOPE("simulate");
+
+        previousElapsedSeconds = elapsedSeconds;
+        elapsedSeconds += step.count() / 1000.0;
+
+        const glm::vec3 eye = glm::vec3(
+            20 * pointer.x - 10,
+            20 * pointer.y - 10,
+            -5);
+
+        // looks at the origin, only dirty when the input moved
+        camera.lookAt(eye, glm::vec3(0, 0, 0));
+
+        if (camera.update())
+        {
+            ++cameraVersion;
+        }
+
+        transforms.update();
+
+        // the whole ring turns: every world matrix changes, then only the visible cubes are kept
+        field.update(transforms.getWorld(scene) * glm::rotate(glm::mat4(1.f), static_cast<float>(elapsedSeconds) * 0.2f, glm::vec3(0.f, 1.f, 0.f)));
+        field.cull(camera.getFrustum(), visibleField);
+
+        return true;
+    }
+
+    void extract(FrameSnapshot& target) const
+    {
+        ISC_PROFILE_SCOPE("extract");
+
+        target.previousElapsedSeconds = previousElapsedSeconds;
+        target.elapsedSeconds = elapsedSeconds;
+        target.pointer = pointer;
+
+        if (target.cameraVersion != cameraVersion)
+        {
+            target.cameraVersion = cameraVersion;
+            target.camera.view = camera.getView();
+            target.camera.projection = camera.getProjection();
+            target.camera.viewProjection = camera.getViewProjection();
+            target.camera.position = glm::vec4(camera.getPosition(), 1.f);
+        }
+
+        target.cube = transforms.getWorld(cube.transform);
+
+        // the snapshots are reused: no allocation once the vectors are big enough
+        target.field.clear();
+
+        for (const auto index : visibleField)
+        {
+            target.field.push_back(field.getWorld(index));
+        }
+    }
+
+    void render(DeltaTime deltaTime, double alpha)
+    {
+        extract(snapshot);
+        render(snapshot, deltaTime, alpha);
+    }
+
+    // main thread, only reads the simulation through the snapshot
+    void render(const FrameSnapshot& frame, DeltaTime deltaTime, double alpha)
+    {
+        ISC_PROFILE_SCOPE("render");
+
+        profiler.update(deltaTime);
+        gpuProfiler.beginFrame();
+
+        // GL work posted by the jobs
+        jobs.executeMainThreadJobs();
+
         // Clear the screen
         /////////////////////////////////////////////////////////////////////////////////////////
 
         GL(glClearColor(0.f, 0x33 / 255.f, 0x66 / 255.f, 1.f));
         GL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
 
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0); // transparent overlay
-        SDL_RenderClear(renderer);
+        renderer.beginFrame(); // transparent overlay
 
         // 3D rendering
         /////////////////////////////////////////////////////////////////////////////////////////
 
-        triangle.render();
+        gpuProfiler.beginPass("3d");
 
-        glm::mat4 Projection = glm::perspective(
-            glm::radians(45.0f),
-            (float)window.getSize().x / (float)window.getSize().y,
-            0.01f, 1000.0f);
+        renderQueue.submit(triangle.draw(geometry, shaders));
 
-        isc::vec2<int32_t> mouse;
-        SDL_GetMouseState(&mouse.x, &mouse.y);
+        // one upload for every program, none if the camera didn't change
+        if (frame.cameraVersion != uploadedCameraVersion)
+        {
+            cameraBlock.update(glState, frame.camera);
+            uploadedCameraVersion = frame.cameraVersion;
+        }
 
-        isc::vec2<float> input = touchLocation.has_value()
-            ? touchLocation.value()
-            : (isc::vec2<float>(mouse) / isc::vec2<float>(window.getSize()));
+        cameraBlock.bind(glState, isc::gl::CameraBinding);
+
+        // per object blocks go in the ring, uploaded together before the queue runs
+        objectBlocks.begin();
 
-        glm::mat4 View = glm::lookAt(
-            glm::vec3(
-                20 * input.x - 10,
-                20 * input.y - 10,
-                -5),
-            glm::vec3(0, 0, 0), // and looks at the origin
-            glm::vec3(0, 1, 0)  // Head is up (set to 0,-1,0 to look upside-down)
-        );
+        isc::gl::ObjectBlock object;
+        object.model = frame.cube;
+        object.color = glm::vec4(0.f, 0.f, 0.f, 1.f);
 
-        glm::mat4 Model = glm::mat4(1.0f);
-        glm::mat4 mvp = Projection * View * Model;
+        const auto objectRange = objectBlocks.push(object);
 
-        GL(glUseProgram(cube.program));
+        isc::gl::DrawCommand cubeCommand = cube.draw(geometry, shaders, true);
+        cubeCommand.uniformBuffer = objectRange.buffer;
+        cubeCommand.uniformOffset = objectRange.offset;
+        cubeCommand.uniformSize = objectRange.size;
 
-        GLint matrixID = GL(glGetUniformLocation(cube.program, "MVP"));
-        GL(glUniformMatrix4fv(matrixID, 1, GL_FALSE, &mvp[0][0]));
+        renderQueue.submit(cubeCommand, 1);
 
-        new2dLayer();
-        cube.render(true);
+        // the visible cubes of the ring
+        {
+            ISC_PROFILE_SCOPE("field");
+
+            object.color = glm::vec4(1.f);
+
+            for (const glm::mat4& model : frame.field)
+            {
+                object.model = model;
+
+                const auto range = objectBlocks.push(object);
+                cubeCommand.uniformOffset = range.offset;
+
+                renderQueue.submit(cubeCommand, 1);
+            }
+        }
+
+        objectBlocks.flush(glState);
+        renderQueue.execute(glState);
+
+        gpuProfiler.endPass();
+
+        // Sprites
+        /////////////////////////////////////////////////////////////////////////////////////////
+
+        const auto windowSize = isc::vec2<int32_t>(window->getSize());
+        const auto screen = glm::vec2(windowSize.x, windowSize.y);
+
+        gpuProfiler.beginPass("sprites");
+
+        sprites.begin(glm::ortho(0.f, screen.x, screen.y, 0.f, -1.f, 1.f));
+
+        // between the last two steps: smooth motion whatever the refresh rate of the display
+        const double time = frame.previousElapsedSeconds + (frame.elapsedSeconds - frame.previousElapsedSeconds) * alpha;
+
+        // the ball bounces between the paddles, the left one follows the input
+        const float bounce = static_cast<float>(std::abs(std::fmod(time * 0.5, 2.0) - 1.0));
+        const auto ball = glm::vec2(screen.x * (0.1f + 0.8f * bounce), screen.y * (0.5f + 0.3f * std::sin(static_cast<float>(time) * 1.7f)));
+        const auto paddleSize = glm::vec2(screen.x * 0.02f, screen.y * 0.2f);
+
+        isc::gl::Sprite sprite;
+        sprite.color = isc::gl::SpriteBatch::packColor(255, 255, 255);
+
+        sprite.size = paddleSize;
+        sprite.position = glm::vec2(screen.x * 0.05f, frame.pointer.y * screen.y);
+        sprites.draw(isc::gl::SpriteBatch::NoTexture, sprite);
+
+        sprite.position = glm::vec2(screen.x * 0.95f, ball.y);
+        sprites.draw(isc::gl::SpriteBatch::NoTexture, sprite);
+
+        if (auto ballImage = atlas.find(BallImage))
+        {
+            sprite.size = glm::vec2(screen.y * 0.03f);
+            sprite.position = ball;
+            sprite.uv = ballImage->uv;
+            sprite.color = isc::gl::SpriteBatch::packColor(255, 215, 0);
+            sprites.draw(ballImage->texture, sprite);
+        }
+
+        sprites.end(glState);
+
+        gpuProfiler.endPass();
 
         // 2D rendering
         /////////////////////////////////////////////////////////////////////////////////////////
 
-        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-        SDL_RenderDrawLine(renderer, 0, 0, window.getSize().x, window.getSize().y);
+        renderer.setDrawColor(255, 0, 0, 255);
+        renderer.drawLine(0, 0, windowSize.x, windowSize.y);
 
-        SDL_SetRenderDrawColor(renderer, 255, 215, 0, 255);
-        SDL_RenderDrawLine(renderer, 0, window.getSize().y, window.getSize().x, 0);
+        renderer.setDrawColor(255, 215, 0, 255);
+        renderer.drawLine(0, windowSize.y, windowSize.x, 0);
 
         // Render 2D framebuffer
         /////////////////////////////////////////////////////////////////////////////////////////
 
-        usingSurfaceTexture(surface, [&]()
+        gpuProfiler.beginPass("overlay");
+
+        size_t uploadedBytes = usingSurfaceTexture(glState, overlay, renderer, [&]()
         {
-            new2dLayer();
-            framebufferQuad.render();
+            isc::gl::DrawCommand quadCommand = framebufferQuad.draw(geometry, shaders);
+            quadCommand.texture = overlay.getId();
+
+            renderQueue.submit(quadCommand, 2, true);
+            renderQueue.execute(glState);
         });
 
-        window.swap();
-    }
+        gpuProfiler.endPass();
 
-    bool loop(DeltaTime deltaTime)
-    {
-        profiler.update(deltaTime);
+        profiler.addUploadedBytes(uploadedBytes);
+        profiler.addStateChanges(glState.getIssuedCount(), glState.getElidedCount());
+        glState.resetCounters();
 
-        render(deltaTime);
+        gpuProfiler.endFrame();
+        gpuProfiler.report(std::cout);
 
-        return update(deltaTime);;
+        window->swap();
     }
 };
 
 #include "PongEngine.hpp"
-#include <Engine/SDL/Renderer.hpp>
 
 int main(int argc, char** argv)
 {
-    return initGameLoop<GameLoop>();
+    // ./pong --pack-atlas <name> <image.bmp>... (ids follow the order of the images)
+    if (argc >= 4 && std::string(argv[1]) == "--pack-atlas")
+    {
+        std::vector<isc::gl::AtlasImage> images;
+
+        for (int i = 3; i < argc; ++i)
+        {
+            images.push_back({ static_cast<uint32_t>(i - 3), argv[i] });
+        }
+
+        try
+        {
+            const size_t pages = isc::gl::TextureAtlas::pack(images, { 1024, 1024 }, argv[2]);
+            std::cout << "[Atlas] " << images.size() << " images packed in " << pages << " pages" << std::endl;
+        }
+        catch (const isc::RuntimeException&)
+        {
+            // the exception already printed what went wrong
+            std::cout << "Usage: " << argv[0] << " --pack-atlas <name> <image.bmp>..." << std::endl;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    isc::FixedTimestepSettings timestep;
+    timestep.tickRate = 60.0;
+
+    isc::jobs::JobSystem jobs;
+
+#ifdef ISC_HEADLESS
+    // ./pong --benchmark <frames>
+    if (argc >= 3 && std::string(argv[1]) == "--benchmark")
+    {
+        const size_t frames = std::stoul(argv[2]);
+
+        return initBenchmarkLoop<GameLoop>(frames, timestep, jobs, std::make_unique<isc::HeadlessWindow>());
+    }
+#endif
+
+    // ./pong --pipelined: the simulation runs on a worker, one frame ahead of the rendering
+    if (argc >= 2 && std::string(argv[1]) == "--pipelined")
+    {
+        return initPipelinedGameLoop<GameLoop>(jobs, timestep, jobs, std::make_unique<isc::Window>());
+    }
+
+    return initFixedGameLoop<GameLoop>(timestep, jobs, std::make_unique<isc::Window>());
 }
\ No newline at end of file